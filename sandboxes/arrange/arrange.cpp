@@ -0,0 +1,133 @@
+#include <iostream>
+#include <iomanip>
+#include <string>
+
+#include <libslic3r/libslic3r.h>
+#include <libslic3r/ClipperUtils.hpp>
+#include <libslic3r/Model.hpp>
+#include <libslic3r/ModelArrange.hpp>
+#include <libnest2d/tools/benchmark.h>
+
+const std::string USAGE_STR = {
+    "Usage: arrange [number_of_instances]"
+};
+
+using namespace Slic3r;
+
+// Small parts of four shapes: a box, a hexagonal prism, an elliptic cylinder and a triangular prism.
+static Model make_model(size_t num_instances)
+{
+    Model model;
+    std::vector<TriangleMesh> meshes = { make_cube(12., 8., 5.), make_cylinder(6., 5., PI / 3.), make_cylinder(5., 5., PI / 8.), make_cylinder(5., 5., 2. * PI / 3.) };
+    meshes[2].scale(Vec3d(1.4, 0.8, 1.));
+    for (TriangleMesh &mesh : meshes) {
+        ModelObject *object = model.add_object();
+        object->add_volume(mesh);
+    }
+    for (size_t i = 0; i < num_instances; ++ i)
+        model.objects[i % meshes.size()]->add_instance();
+    return model;
+}
+
+// Number of instances placed onto the bed and the fraction of the bed area they cover.
+static void print_density(const Model &model, const BoundingBox &bed)
+{
+    size_t on_bed = 0, total = 0;
+    double area = 0.;
+    for (const ModelObject *object : model.objects)
+        for (const ModelInstance *instance : object->instances) {
+            Polygon hull = object->convex_hull_2d(instance->get_matrix());
+            BoundingBox bb(hull.points);
+            if (bed.contains(bb.min) && bed.contains(bb.max)) {
+                area += hull.area();
+                ++ on_bed;
+            }
+            ++ total;
+        }
+    std::cout << on_bed << " of " << total << " instances on the bed, covering " << std::setprecision(3) <<
+        100. * area / (double(bed.size()(0)) * double(bed.size()(1))) << "% of it" << std::endl;
+}
+
+// Arrange as many instances as fit onto one bed with the skyline, then check that all of them lie inside the bed
+// and that no two of them overlap.
+static bool check_skyline(const Polyline &bed, size_t num_instances)
+{
+    Model model = make_model(num_instances);
+    arr::WipeTowerInfo wti;
+    arr::BedShapeHint hint = arr::bedShape(bed);
+    hint.mode = arr::ArrangeMode::SKYLINE;
+    if (! arr::arrange(model, wti, coord_t(scale_(6.)), bed, hint, false, [](unsigned) {}, []() { return false; })) {
+        std::cout << num_instances << " instances did not fit onto a single bed" << std::endl;
+        return false;
+    }
+
+    // Allow the hulls to touch the bed edge and each other.
+    Polygons bed_grown = offset(Polygon(bed.points), float(SCALED_EPSILON));
+    Polygons hulls;
+    for (const ModelObject *object : model.objects)
+        for (const ModelInstance *instance : object->instances) {
+            Polygon hull = object->convex_hull_2d(instance->get_matrix());
+            for (const Point &pt : hull.points)
+                if (bed_grown.empty() || ! bed_grown.front().contains(pt)) {
+                    std::cout << "Instance outside of the bed at " << unscale<double>(pt(0)) << ", " << unscale<double>(pt(1)) << std::endl;
+                    return false;
+                }
+            Polygons shrunk = offset(hull, - float(SCALED_EPSILON));
+            if (! shrunk.empty())
+                hulls.emplace_back(std::move(shrunk.front()));
+        }
+
+    std::vector<BoundingBox> bboxes;
+    for (const Polygon &hull : hulls)
+        bboxes.emplace_back(hull.points);
+    for (size_t i = 0; i < hulls.size(); ++ i)
+        for (size_t j = i + 1; j < hulls.size(); ++ j)
+            if (bboxes[i].overlap(bboxes[j]) && ! intersection(Polygons{ hulls[i] }, Polygons{ hulls[j] }).empty()) {
+                std::cout << "Instances " << i << " and " << j << " overlap" << std::endl;
+                return false;
+            }
+    return true;
+}
+
+int main(const int argc, const char *argv[]) {
+    using std::cout; using std::endl;
+
+    if (argc > 1 && std::string(argv[1]) == "--help") {
+        cout << USAGE_STR << endl;
+        return EXIT_SUCCESS;
+    }
+    size_t num_instances = argc > 1 ? size_t(std::stoul(argv[1])) : 1000;
+
+    // MK3 sized bed
+    Polyline bed;
+    for (const Vec2d &pt : { Vec2d(0., 0.), Vec2d(250., 0.), Vec2d(250., 210.), Vec2d(0., 210.) })
+        bed.append(Point::new_scale(pt(0), pt(1)));
+    BoundingBox bed_bb(bed.points);
+
+    for (arr::ArrangeMode mode : { arr::ArrangeMode::SKYLINE, arr::ArrangeMode::NFP }) {
+        Model model = make_model(num_instances);
+        arr::WipeTowerInfo wti;
+        arr::BedShapeHint hint;
+        hint.type = arr::BedShapeType::WHO_KNOWS;
+        hint.mode = mode;
+
+        Benchmark bench;
+        bench.start();
+        // Returns false if the instances did not fit onto a single bed, the rest is placed next to it.
+        arr::arrange(model, wti, coord_t(scale_(6.)), bed, hint, false, [](unsigned) {}, []() { return false; });
+        bench.stop();
+
+        cout << (mode == arr::ArrangeMode::SKYLINE ? "Skyline: " : "NFP:     ") << bench.getElapsedSec() << " seconds, ";
+        print_density(model, bed_bb);
+    }
+
+    // Box shaped MK3 bed and a circular bed of 200mm diameter.
+    Polyline circle;
+    for (int i = 0; i < 72; ++ i)
+        circle.append(Point::new_scale(100. + 100. * cos(2. * PI * i / 72.), 100. + 100. * sin(2. * PI * i / 72.)));
+    if (! check_skyline(bed, 150) || ! check_skyline(circle, 50))
+        return EXIT_FAILURE;
+    cout << "Skyline placements are inside the box and the circular bed and do not overlap" << endl;
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,118 @@
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <set>
+#include <tuple>
+#include <random>
+#include <cstdio>
+#include <cmath>
+
+#include <libslic3r/libslic3r.h>
+#include <libslic3r/ExtrusionEntity.hpp>
+#include <libslic3r/GCode/Analyzer.hpp>
+#include <libslic3r/GCode/PreviewData.hpp>
+#include <libnest2d/tools/benchmark.h>
+
+const std::string USAGE_STR = {
+    "Usage: gcodepreview [number_of_layers] [islands_per_layer]"
+};
+
+using namespace Slic3r;
+
+typedef std::tuple<int, int, float, float, float> AttributesKey;
+
+// Synthetic two extruder print: perimeter loops with a constant width, gap fills with a variable width
+// and infill lines, the islands connected by travels. The attribute combinations as written to the G-code
+// are collected into attributes.
+static std::string make_layer(size_t layer_id, size_t islands, double &E, std::mt19937 &rng, std::set<AttributesKey> &attributes)
+{
+    std::uniform_real_distribution<float> dist_width(0.2f, 0.6f), dist_feedrate(15.f, 40.f);
+    char   buf[256];
+    int    extruder_id = int(layer_id % 2);
+    float  height      = 0.2f;
+    double z           = 0.2 * double(layer_id + 1);
+    std::string gcode;
+    sprintf(buf, "T%d\nG1 Z%.3f F7800\n;%s%f\n", extruder_id, z, GCodeAnalyzer::Height_Tag.c_str(), height);
+    gcode += buf;
+
+    auto extrude = [&](ExtrusionRole role, float width, float feedrate, const std::vector<Vec2d> &pts) {
+        sprintf(buf, "G1 X%.3f Y%.3f F9000\n;%s%d\n;%s%f\n;%s%f\nG1 F%.3f\n", pts.front()(0), pts.front()(1),
+            GCodeAnalyzer::Extrusion_Role_Tag.c_str(), int(role), GCodeAnalyzer::Width_Tag.c_str(), width,
+            GCodeAnalyzer::Mm3_Per_Mm_Tag.c_str(), width * height, feedrate * 60.f);
+        gcode += buf;
+        for (size_t i = 1; i < pts.size(); ++ i) {
+            E += 0.05 * (pts[i] - pts[i - 1]).norm();
+            sprintf(buf, "G1 X%.3f Y%.3f E%.5f\n", pts[i](0), pts[i](1), E);
+            gcode += buf;
+        }
+        attributes.insert(AttributesKey(int(role), extruder_id, width, height, feedrate));
+    };
+
+    for (size_t island = 0; island < islands; ++ island) {
+        Vec2d center(10. + 12. * double(island % 16), 10. + 12. * double(island / 16));
+        for (int loop_id = 0; loop_id < 3; ++ loop_id) {
+            std::vector<Vec2d> pts;
+            double r = 5. - 0.45 * loop_id;
+            for (int i = 0; i <= 64; ++ i)
+                pts.emplace_back(center + r * Vec2d(cos(2. * PI * (i % 64) / 64.), sin(2. * PI * (i % 64) / 64.)));
+            extrude(loop_id == 0 ? erExternalPerimeter : erPerimeter, 0.45f, loop_id == 0 ? 25.f : 45.f, pts);
+        }
+        for (int i = 0; i < 4; ++ i)
+            extrude(erGapFill, dist_width(rng), dist_feedrate(rng), { center + Vec2d(-1., 0.2 * i), center + Vec2d(1., 0.2 * i) });
+        for (double y = -3.5; y < 3.5; y += 1.8)
+            extrude(erInternalInfill, 0.45f, 80.f, { center + Vec2d(-3.5, y), center + Vec2d(3.5, y), center + Vec2d(3.5, y + 0.9), center + Vec2d(-3.5, y + 0.9) });
+    }
+    return gcode;
+}
+
+int main(const int argc, const char *argv[]) {
+    using std::cout; using std::endl;
+
+    if (argc > 1 && std::string(argv[1]) == "--help") {
+        cout << USAGE_STR << endl;
+        return EXIT_SUCCESS;
+    }
+    size_t num_layers = argc > 1 ? size_t(std::stoul(argv[1])) : 1000;
+    size_t islands    = argc > 2 ? size_t(std::stoul(argv[2])) : 64;
+
+    Benchmark               bench;
+    GCodeAnalyzer           analyzer;
+    GCodePreviewData        preview_data;
+    std::mt19937            rng(0);
+    std::set<AttributesKey> attributes;
+    double                  E = 0.;
+    size_t                  gcode_size = 0;
+
+    analyzer.reset();
+    bench.start();
+    for (size_t layer_id = 0; layer_id < num_layers; ++ layer_id) {
+        std::string gcode = make_layer(layer_id, islands, E, rng, attributes);
+        gcode_size += gcode.size();
+        analyzer.process_gcode(gcode);
+    }
+    bench.stop();
+    cout << "Analyzing " << gcode_size / (1024 * 1024) << " MB of G-code: " << bench.getElapsedSec() << " seconds." << endl;
+
+    bench.start();
+    analyzer.calc_gcode_preview_data(preview_data, []() {});
+    bench.stop();
+    cout << "Calculating the preview data: " << bench.getElapsedSec() << " seconds." << endl;
+
+    size_t num_paths = 0, num_points = 0;
+    for (const GCodePreviewData::Extrusion::Layer &layer : preview_data.extrusion.layers) {
+        num_paths  += layer.paths_count();
+        num_points += layer.points.size();
+    }
+    // The extrusions were stored as an ExtrusionPath per path before, each with its own polyline.
+    size_t memory_extrusion_paths = num_paths * sizeof(ExtrusionPath) + num_points * sizeof(Point);
+
+    cout << preview_data.extrusion.layers.size() << " layers, " << num_paths << " paths, " << num_points << " points" << endl;
+    cout << "Path attributes: " << attributes.size() << " combinations in the G-code, " <<
+        preview_data.extrusion.paths_attributes.size() << " stored, " << sizeof(GCodePreviewData::Extrusion::PathAttributes) << " bytes each" << endl;
+    cout << "Extrusions as ExtrusionPaths: " << memory_extrusion_paths / 1024 << " kB" << endl;
+    cout << "Extrusions:                   " << preview_data.extrusion.memory_used() / 1024 << " kB" << endl;
+    cout << "Travels:                      " << preview_data.travel.memory_used() / 1024 << " kB" << endl;
+    cout << "Preview data total:           " << preview_data.memory_used() / 1024 << " kB" << endl;
+
+    return (num_paths > 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,105 @@
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <random>
+
+#include <libslic3r/libslic3r.h>
+#include <libslic3r/GCodeWriter.hpp>
+#include <libnest2d/tools/benchmark.h>
+
+const std::string USAGE_STR = {
+    "Usage: gcodewriter [number_of_moves]"
+};
+
+using namespace Slic3r;
+
+// The G-code lines as formatted by GCodeWriter with std::ostringstream before the fixed point formatter.
+static std::string stream_extrude_to_xy(const Vec2d &point, double E)
+{
+    std::ostringstream gcode;
+    gcode << "G1 X" << std::fixed << std::setprecision(3) << point(0)
+          <<   " Y" << std::fixed << std::setprecision(3) << point(1)
+          <<   " E" << std::fixed << std::setprecision(5) << E << "\n";
+    return gcode.str();
+}
+
+static std::string stream_travel_to_xy(const Vec2d &point, double F)
+{
+    std::ostringstream gcode;
+    gcode << "G1 X" << std::fixed << std::setprecision(3) << point(0)
+          <<   " Y" << std::fixed << std::setprecision(3) << point(1)
+          <<   " F" << std::fixed << std::setprecision(3) << F << "\n";
+    return gcode.str();
+}
+
+int main(const int argc, const char *argv[]) {
+    using std::cout; using std::endl;
+
+    if (argc > 1 && std::string(argv[1]) == "--help") {
+        cout << USAGE_STR << endl;
+        return EXIT_SUCCESS;
+    }
+    size_t num_moves = argc > 1 ? size_t(std::stoul(argv[1])) : 2000000;
+
+    // Moves on a 250x210 bed with short extrusions, as produced by the perimeters and infill.
+    std::mt19937 rng(0);
+    std::uniform_real_distribution<double> dist_x(0., 250.), dist_y(0., 210.), dist_e(0., 0.5);
+    std::vector<Vec2d>  points(num_moves);
+    std::vector<double> dE(num_moves);
+    for (size_t i = 0; i < num_moves; ++ i) {
+        points[i] = Vec2d(dist_x(rng), dist_y(rng));
+        dE[i]     = dist_e(rng);
+    }
+
+    GCodeWriter writer;
+    writer.config.use_relative_e_distances.value = false;
+    writer.set_extruders({ 0 });
+    writer.set_extruder(0);
+    const double F = writer.config.travel_speed.value * 60.;
+
+    // Reference output of the stream formatting, the extruder E is accumulated the same way Extruder::extrude() does.
+    Benchmark   bench;
+    std::string gcode_stream;
+    bench.start();
+    double E = writer.extruder()->E();
+    for (size_t i = 0; i < num_moves; ++ i) {
+        if (i % 8 == 0)
+            gcode_stream += stream_travel_to_xy(points[i], F);
+        else {
+            E += dE[i];
+            gcode_stream += stream_extrude_to_xy(points[i], E);
+        }
+    }
+    bench.stop();
+    double time_stream = bench.getElapsedSec();
+
+    std::string gcode;
+    bench.start();
+    for (size_t i = 0; i < num_moves; ++ i) {
+        if (i % 8 == 0)
+            writer.travel_to_xy(gcode, points[i]);
+        else
+            writer.extrude_to_xy(gcode, points[i], dE[i]);
+    }
+    bench.stop();
+    double time_writer = bench.getElapsedSec();
+
+    cout << num_moves << " moves, " << gcode.size() / 1024 << " kB of G-code" << endl;
+    cout << "std::ostringstream:            " << std::setprecision(6) << time_stream << " seconds." << endl;
+    cout << "GCodeWriter fixed point:       " << time_writer << " seconds." << endl;
+
+    if (gcode != gcode_stream) {
+        size_t i = 0;
+        while (i < gcode.size() && i < gcode_stream.size() && gcode[i] == gcode_stream[i])
+            ++ i;
+        size_t line_start = gcode.rfind('\n', i);
+        line_start = (line_start == std::string::npos) ? 0 : line_start + 1;
+        cout << "Output differs from the stream formatting:" << endl <<
+            gcode_stream.substr(line_start, gcode_stream.find('\n', i) - line_start) << endl <<
+            gcode.substr(line_start, gcode.find('\n', i) - line_start) << endl;
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
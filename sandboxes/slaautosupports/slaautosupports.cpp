@@ -0,0 +1,132 @@
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include <libslic3r/libslic3r.h>
+#include <libslic3r/TriangleMesh.hpp>
+#include <libslic3r/SLA/SLAAutoSupports.hpp>
+#include <libslic3r/SLA/SLACommon.hpp>
+#include <libnest2d/tools/benchmark.h>
+
+const std::string USAGE_STR = {
+    "Usage: slaautosupports [plate | lattice | stlfilename.stl]"
+};
+
+using namespace Slic3r;
+
+// A large floating plate with a grid of small floating islands above it, the flat bottoms are covered
+// by the Poisson disk sampling of the islands.
+static TriangleMesh make_plate()
+{
+    TriangleMesh mesh = make_cube(120., 120., 2.);
+    mesh.translate(0.f, 0.f, 5.f);
+    for (int i = 0; i < 8; ++ i)
+        for (int j = 0; j < 8; ++ j) {
+            TriangleMesh island = make_cube(6., 6., 2.);
+            island.translate(4.f + 15.f * i, 4.f + 15.f * j, 10.f);
+            mesh.merge(island);
+        }
+    return mesh;
+}
+
+// A lattice of 40x40 thin pillars connected by two bars, producing over a thousand islands per layer
+// to be linked with the islands of the layer below.
+static TriangleMesh make_lattice()
+{
+    TriangleMesh mesh;
+    for (int i = 0; i < 40; ++ i)
+        for (int j = 0; j < 40; ++ j) {
+            TriangleMesh pillar = make_cube(0.8, 0.8, 10.);
+            pillar.translate(2.f * i, 2.f * j, 0.f);
+            mesh.merge(pillar);
+        }
+    for (int k = 0; k < 2; ++ k) {
+        TriangleMesh bar = make_cube(80., 0.8, 0.8);
+        bar.translate(0.f, 0.f, 3.f + 4.f * k);
+        mesh.merge(bar);
+    }
+    return mesh;
+}
+
+// Mean, standard deviation and minimum of the distances of the support points to their nearest neighbors
+// in the same layer, measuring how uniformly the islands are covered.
+static void print_coverage(const std::vector<sla::SupportPoint> &points)
+{
+    std::vector<Vec3f> pts;
+    for (const sla::SupportPoint &pt : points)
+        pts.emplace_back(pt.pos);
+    std::sort(pts.begin(), pts.end(), [](const Vec3f &a, const Vec3f &b) { return a(0) < b(0); });
+    double sum = 0., sum2 = 0., dmin = std::numeric_limits<double>::max();
+    size_t cnt = 0;
+    for (size_t i = 0; i < pts.size(); ++ i) {
+        double d = std::numeric_limits<double>::max();
+        // Sweep both directions along x until the x distance alone exceeds the best distance found.
+        for (size_t j = i + 1; j < pts.size() && pts[j](0) - pts[i](0) < d; ++ j)
+            if (std::abs(pts[j](2) - pts[i](2)) < EPSILON)
+                d = std::min(d, double((pts[j] - pts[i]).norm()));
+        for (size_t j = i; j > 0 && pts[i](0) - pts[j - 1](0) < d; -- j)
+            if (std::abs(pts[j - 1](2) - pts[i](2)) < EPSILON)
+                d = std::min(d, double((pts[j - 1] - pts[i]).norm()));
+        if (d < std::numeric_limits<double>::max()) {
+            sum  += d;
+            sum2 += d * d;
+            dmin  = std::min(dmin, d);
+            ++ cnt;
+        }
+    }
+    if (cnt == 0)
+        return;
+    double mean = sum / double(cnt);
+    std::cout << "Nearest neighbor distance: mean " << mean << " mm, deviation " << std::sqrt(std::max(0., sum2 / double(cnt) - mean * mean)) <<
+        " mm, minimum " << dmin << " mm" << std::endl;
+}
+
+int main(const int argc, const char *argv[]) {
+    using std::cout; using std::endl;
+
+    if (argc > 1 && std::string(argv[1]) == "--help") {
+        cout << USAGE_STR << endl;
+        return EXIT_SUCCESS;
+    }
+
+    std::string model_name = argc > 1 ? argv[1] : "plate";
+    TriangleMesh mesh;
+    if (model_name == "plate")
+        mesh = make_plate();
+    else if (model_name == "lattice")
+        mesh = make_lattice();
+    else
+        mesh.ReadSTLFile(argv[1]);
+    mesh.repair();
+    mesh.require_shared_vertices();
+
+    // Slice the model the same way SLAPrint does for the support points, at 0.05mm.
+    BoundingBoxf3 bb = mesh.bounding_box();
+    std::vector<float> heights;
+    for (double z = bb.min(2) + 0.025; z < bb.max(2); z += 0.05)
+        heights.emplace_back(float(z));
+    std::vector<ExPolygons> slices;
+    TriangleMeshSlicer slicer(&mesh);
+    slicer.slice(heights, 0.f, &slices, []() {});
+    sla::EigenMesh3D emesh(mesh);
+
+    SLAAutoSupports::Config config;
+    config.density_relative = 4.f;
+    config.minimal_distance = 0.3f;
+    config.head_diameter    = 0.8f;
+
+    Benchmark bench;
+    bench.start();
+    SLAAutoSupports auto_supports(mesh, emesh, slices, heights, config, []() {}, [](int) {});
+    bench.stop();
+
+    const std::vector<sla::SupportPoint> &points = auto_supports.output();
+    cout << heights.size() << " layers, " << points.size() << " support points in " << bench.getElapsedSec() << " seconds, " <<
+        double(points.size()) / bench.getElapsedSec() << " points/s" << endl;
+    print_coverage(points);
+
+    return points.empty() ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,81 @@
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <cmath>
+
+#include <libslic3r/libslic3r.h>
+#include <libslic3r/TriangleMesh.hpp>
+#include <libslic3r/SLA/SLABasePool.hpp>
+#include <libnest2d/tools/benchmark.h>
+
+const std::string USAGE_STR = {
+    "Usage: slapad [stlfilename.stl]"
+};
+
+using namespace Slic3r;
+
+// Ground layer of a plate full of miniatures: 20x20 round feet of 3mm diameter on a 4mm pitch.
+static Polygons make_ground_layer()
+{
+    Polygons ground;
+    for (int i = 0; i < 20; ++ i)
+        for (int j = 0; j < 20; ++ j) {
+            Polygon circle;
+            for (int k = 0; k < 45; ++ k) {
+                double angle = 2. * PI * k / 45.;
+                circle.points.emplace_back(scale_(4. * i + 1.5 * cos(angle)), scale_(4. * j + 1.5 * sin(angle)));
+            }
+            ground.emplace_back(std::move(circle));
+        }
+    return ground;
+}
+
+int main(const int argc, const char *argv[]) {
+    using std::cout; using std::endl;
+
+    if (argc > 1 && std::string(argv[1]) == "--help") {
+        cout << USAGE_STR << endl;
+        return EXIT_SUCCESS;
+    }
+
+    Polygons ground;
+    if (argc > 1) {
+        TriangleMesh model;
+        model.ReadSTLFile(argv[1]);
+        model.repair();
+        model.align_to_origin();
+        ExPolygons base;
+        sla::base_plate(model, base, 0.1f);
+        for (const ExPolygon &expoly : base)
+            ground.emplace_back(expoly.contour);
+    } else
+        ground = make_ground_layer();
+    if (ground.empty())
+        return EXIT_FAILURE;
+
+    Benchmark       bench;
+    sla::PoolConfig cfg;
+    TriangleMesh    pad;
+    bench.start();
+    sla::create_base_pool(ground, pad, {}, cfg);
+    bench.stop();
+    cout << ground.size() << " ground islands" << endl;
+    cout << "create_base_pool():              " << std::setprecision(4) << bench.getElapsedSec() << " seconds, " << pad.facets_count() << " facets" << endl;
+
+    bench.start();
+    Polygons outline = sla::base_pool_outline(ground, cfg);
+    bench.stop();
+    cout << "base_pool_outline():             " << bench.getElapsedSec() << " seconds" << endl;
+
+    // Changing the wall height or the slope keeps the merge distance and thus the outline, as the pad
+    // parameters tweaked in the UI do.
+    cfg.min_wall_height_mm += 1.;
+    cfg.wall_slope          = PI / 3.;
+    TriangleMesh pad_from_outline;
+    bench.start();
+    sla::create_base_pool_from_outline(outline, pad_from_outline, {}, cfg);
+    bench.stop();
+    cout << "create_base_pool_from_outline(): " << bench.getElapsedSec() << " seconds, " << pad_from_outline.facets_count() << " facets" << endl;
+
+    return pad_from_outline.facets_count() > 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,82 @@
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <random>
+
+#include <libslic3r/libslic3r.h>
+#include <libslic3r/TriangleMesh.hpp>
+#include <libslic3r/SLA/SLACommon.hpp>
+#include <libnest2d/tools/benchmark.h>
+
+#include <tbb/task_scheduler_init.h>
+
+const std::string USAGE_STR = {
+    "Usage: slaraycast [stlfilename.stl] [number_of_rays]"
+};
+
+using namespace Slic3r;
+
+int main(const int argc, const char *argv[]) {
+    using std::cout; using std::endl;
+
+    if (argc > 1 && std::string(argv[1]) == "--help") {
+        cout << USAGE_STR << endl;
+        return EXIT_SUCCESS;
+    }
+
+    // Without a model, a finely tessellated sphere with a box, similar in size to a miniature.
+    TriangleMesh model;
+    if (argc > 1) {
+        model.ReadSTLFile(argv[1]);
+        model.repair();
+    } else {
+        model = make_sphere(10., 2. * PI / 720.);
+        TriangleMesh box = make_cube(10., 20., 30.);
+        model.merge(box);
+    }
+    model.require_shared_vertices();
+    size_t num_rays = argc > 2 ? size_t(std::stoul(argv[2])) : 1000000;
+
+    Benchmark bench;
+    bench.start();
+    sla::EigenMesh3D emesh(model);
+    bench.stop();
+    cout << model.facets_count() << " facets, AABB tree built in " << bench.getElapsedSec() << " seconds." << endl;
+
+    // Rays starting in the bounding box of the model into random directions, as the collision checks
+    // of the support tree cast them from the support heads and pillars.
+    BoundingBoxf3 bb = model.bounding_box();
+    std::mt19937 rng(0);
+    std::uniform_real_distribution<double> dist01(0., 1.);
+    std::normal_distribution<double> dist_normal;
+    std::vector<Vec3d> sources(num_rays), dirs(num_rays);
+    for (size_t i = 0; i < num_rays; ++ i) {
+        sources[i] = bb.min + Vec3d(dist01(rng), dist01(rng), dist01(rng)).cwiseProduct(bb.size());
+        dirs[i]    = Vec3d(dist_normal(rng), dist_normal(rng), dist_normal(rng)).normalized();
+    }
+
+    std::vector<sla::EigenMesh3D::hit_result> hits_single;
+    hits_single.reserve(num_rays);
+    bench.start();
+    for (size_t i = 0; i < num_rays; ++ i)
+        hits_single.emplace_back(emesh.query_ray_hit(sources[i], dirs[i]));
+    bench.stop();
+    double time_single = bench.getElapsedSec();
+
+    bench.start();
+    std::vector<sla::EigenMesh3D::hit_result> hits_batch = emesh.query_ray_hits(sources, dirs);
+    bench.stop();
+    double time_batch = bench.getElapsedSec();
+
+    cout << num_rays << " rays, " << tbb::task_scheduler_init::default_num_threads() << " threads" << endl;
+    cout << "query_ray_hit():  " << std::setprecision(4) << time_single << " seconds, " << double(num_rays) / time_single << " rays/s" << endl;
+    cout << "query_ray_hits(): " << time_batch << " seconds, " << double(num_rays) / time_batch << " rays/s" << endl;
+
+    for (size_t i = 0; i < num_rays; ++ i)
+        if (hits_single[i].face() != hits_batch[i].face() || hits_single[i].distance() != hits_batch[i].distance()) {
+            cout << "The hit of ray " << i << " differs" << endl;
+            return EXIT_FAILURE;
+        }
+
+    return EXIT_SUCCESS;
+}
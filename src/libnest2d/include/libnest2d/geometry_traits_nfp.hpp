@@ -191,6 +191,9 @@ inline TPoint<RawShape> referenceVertex(const RawShape& sh)
  * of the input polygons.
  *
  * \tparam RawShape the Polygon data type.
+ * \tparam Unit The number type in which the edge directions are compared.
+ * With an integer type wide enough for the product of two coordinates the
+ * ordering of the edges and thus the whole NFP is exact.
  * \param sh The stationary polygon
  * \param cother The orbiting polygon
  * \return Returns a pair of the NFP and its reference vertex of the two input
@@ -198,7 +201,7 @@ inline TPoint<RawShape> referenceVertex(const RawShape& sh)
  * convex as well in this case.
  *
  */
-template<class RawShape, class Ratio = double>
+template<class RawShape, class Unit = double>
 inline NfpResult<RawShape> nfpConvexOnly(const RawShape& sh,
                                          const RawShape& other)
 {
@@ -274,18 +277,11 @@ inline NfpResult<RawShape> nfpConvexOnly(const RawShape& sh,
             else q[i] = quadrants[((lcos[i] < 0) << 1) + (lsin[i] < 0)];
             
         if(q[0] == q[1]) { // only bother if p1 and p2 are in the same quadrant
-            auto lsq1 = pl::magnsq(p1);     // squared magnitudes, avoid sqrt
-            auto lsq2 = pl::magnsq(p2);     // squared magnitudes, avoid sqrt
-
-            // We will actually compare l^2 * cos^2(phi) which saturates the
-            // cos function. But with the quadrant info we can get the sign back
-            int sign = q[0] == 1 || q[0] == 2 ? -1 : 1;
-            
-            // If Ratio is an actual rational type, there is no precision loss
-            auto pcos1 = Ratio(lcos[0]) / lsq1 * sign * lcos[0];
-            auto pcos2 = Ratio(lcos[1]) / lsq2 * sign * lcos[1];
-            
-            return q[0] < 2 ? pcos1 < pcos2 : pcos1 > pcos2;
+            // Within a quadrant the vectors are less than 90 degrees apart,
+            // so the sign of their cross product tells which one has the
+            // greater angle. This needs no division, thus an integer Unit
+            // gives an exact answer.
+            return pl::dotperp<Vertex, Unit>(p1, p2) < 0;
         }
         
         // If in different quadrants, compare the quadrant indices only.
@@ -9,6 +9,7 @@
 // For parallel for
 #include <functional>
 #include <iterator>
+#include <numeric>
 #include <future>
 #include <atomic>
 
@@ -80,48 +81,118 @@ namespace __itemhash {
 
 using Key = size_t;
 
+inline void combine(Key& seed, Key h) {
+    seed ^= h + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+}
+
+// Hash of the transformed contour of an item relative to its first vertex.
+// Items with the same key have the same shape after rotation and offsetting
+// and differ at most in their translation. The nfp of such items against a
+// third one is the same up to a translation, which makes the key usable for
+// caching nfps.
 template<class S>
 Key hash(const _Item<S>& item) {
-    using Point = TPoint<S>;
-    using Segment = _Segment<Point>;
-
-    static const int N = 26;
-    static const int M = N*N - 1;
-
-    std::string ret;
-    auto& rhs = item.rawShape();
-    auto& ctr = sl::contour(rhs);
-    auto it = ctr.begin();
-    auto nx = std::next(it);
-
-    double circ = 0;
-    while(nx != ctr.end()) {
-        Segment seg(*it++, *nx++);
-        Radians a = seg.angleToXaxis();
-        double deg = Degrees(a);
-        int ms = 'A', ls = 'A';
-        while(deg > N) { ms++; deg -= N; }
-        ls += int(deg);
-        ret.push_back(char(ms)); ret.push_back(char(ls));
-        circ += std::sqrt(seg.template sqlength<double>());
+    using Coord = TCoord<TPoint<S>>;
+
+    auto& ctr = sl::contour(item.transformedShape());
+    Key seed = ctr.size();
+    if(ctr.empty()) return seed;
+
+    auto v0 = *ctr.begin();
+    std::hash<Coord> chash;
+    for(auto& v : ctr) {
+        combine(seed, chash(getX(v) - getX(v0)));
+        combine(seed, chash(getY(v) - getY(v0)));
     }
 
-    it = ctr.begin(); nx = std::next(it);
+    return seed;
+}
+
+// Key of the nfp of the orbiting item around the stationary one.
+inline Key hash(Key stationary, Key orbiter) {
+    Key seed = stationary;
+    combine(seed, orbiter);
+    return seed;
+}
+
+// The transformed contour of an item relative to its first vertex, the data
+// the key of the item is calculated from.
+template<class S>
+std::vector<TPoint<S>> relativeContour(const _Item<S>& item) {
+    auto& ctr = sl::contour(item.transformedShape());
+    std::vector<TPoint<S>> ret;
+    if(ctr.empty()) return ret;
+
+    ret.reserve(ctr.size());
+    auto v0 = *ctr.begin();
+    for(auto& v : ctr) ret.emplace_back(getX(v) - getX(v0), getY(v) - getY(v0));
 
-    while(nx != ctr.end()) {
-        Segment seg(*it++, *nx++);
-        auto l = int(M * std::sqrt(seg.template sqlength<double>()) / circ);
-        int ms = 'A', ls = 'A';
-        while(l > N) { ms++; l -= N; }
-        ls += l;
-        ret.push_back(char(ms)); ret.push_back(char(ls));
+    return ret;
+}
+
+// Whether the transformed contour of the item matches the relative contour.
+// Equal keys do not guarantee this, the hash may collide.
+template<class S>
+bool sameContour(const _Item<S>& item, const std::vector<TPoint<S>>& rel) {
+    auto& ctr = sl::contour(item.transformedShape());
+    if(ctr.size() != rel.size()) return false;
+    if(ctr.empty()) return true;
+
+    auto v0 = *ctr.begin();
+    auto rit = rel.begin();
+    for(auto& v : ctr) {
+        if(getX(v) - getX(v0) != getX(*rit) ||
+           getY(v) - getY(v0) != getY(*rit)) return false;
+        ++rit;
     }
 
-    return std::hash<std::string>()(ret);
+    return true;
 }
 
 template<class S>
-using Hash = std::unordered_map<Key, nfp::NfpResult<S>>;
+bool sameContour(const _Item<S>& item, const _Item<S>& other) {
+    auto& ctr = sl::contour(item.transformedShape());
+    auto& octr = sl::contour(other.transformedShape());
+    if(ctr.size() != octr.size()) return false;
+    if(ctr.empty()) return true;
+
+    auto v0 = *ctr.begin(), ov0 = *octr.begin();
+    auto oit = octr.begin();
+    for(auto& v : ctr) {
+        if(getX(v) - getX(v0) != getX(*oit) - getX(ov0) ||
+           getY(v) - getY(v0) != getY(*oit) - getY(ov0)) return false;
+        ++oit;
+    }
+
+    return true;
+}
+
+// A cached nfp with the contours it was calculated from, which are compared
+// on lookup.
+template<class S>
+struct Entry {
+    std::vector<TPoint<S>> stationary, orbiter;
+    nfp::NfpResult<S> nfp;
+};
+
+template<class S>
+using Hash = std::unordered_multimap<Key, Entry<S>>;
+
+// Find the cached nfp of the orbiter around the stationary item under the
+// given key. Returns cache.end() if the nfp is not cached, which includes the
+// entries with a colliding key but different contours.
+template<class S>
+typename Hash<S>::iterator find(Hash<S>& cache, Key key,
+                                const _Item<S>& stationary,
+                                const _Item<S>& orbiter)
+{
+    auto range = cache.equal_range(key);
+    for(auto it = range.first; it != range.second; ++it)
+        if(sameContour(stationary, it->second.stationary) &&
+           sameContour(orbiter, it->second.orbiter))
+            return it;
+    return cache.end();
+}
 
 }
 
@@ -529,16 +600,16 @@ class _NofitPolyPlacer: public PlacerBoilerplate<_NofitPolyPlacer<RawShape, TBin
 
     using MaxNfpLevel = nfp::MaxNfpLevel<RawShape>;
 
-    using ItemKeys = std::vector<__itemhash::Key>;
-
     // Norming factor for the optimization function
     const double norm_;
 
     // Caching calculated nfps
     __itemhash::Hash<RawShape> nfpcache_;
 
-    // Storing item hash keys
-    ItemKeys item_keys_;
+    // The number of vertices in the cached nfps. The cache is flushed when it
+    // grows over NFPCACHE_MAX_VERTICES.
+    size_t nfpcache_vertices_ = 0;
+    static const size_t NFPCACHE_MAX_VERTICES = 4 * 1024 * 1024;
 
 public:
 
@@ -654,16 +725,68 @@ private:
         }
         // /////////////////////////////////////////////////////////////////////
 
-        __parallel::enumerate(items_.begin(), items_.end(),
-                              [&nfps, &trsh](const Item& sh, size_t n)
+        // Copies of the same shape at the same rotation share their nfps up
+        // to a translation which is fixed by correctNfpPosition. Only the nfps
+        // not seen yet are calculated, in parallel, each of them once.
+        std::vector<__itemhash::Key> keys(items_.size());
+        std::vector<nfp::NfpResult<RawShape>> subnfps(items_.size());
+        std::vector<size_t> missing;
+        std::vector<std::pair<size_t, size_t>> duplicates;
+        std::unordered_multimap<__itemhash::Key, size_t> pending;
+
+        for(size_t n = 0; n < items_.size(); ++n) {
+            const Item& sh = items_[n];
+            keys[n] = __itemhash::hash(__itemhash::hash(sh), itsh.second);
+
+            auto cit = __itemhash::find(nfpcache_, keys[n], sh, trsh);
+            if(cit != nfpcache_.end()) {
+                subnfps[n] = cit->second.nfp;
+                continue;
+            }
+
+            auto range = pending.equal_range(keys[n]);
+            auto pit = range.first;
+            while(pit != range.second &&
+                  !__itemhash::sameContour(sh, items_[pit->second].get()))
+                ++pit;
+
+            if(pit != range.second) duplicates.emplace_back(n, pit->second);
+            else {
+                pending.emplace(keys[n], n);
+                missing.emplace_back(n);
+            }
+        }
+
+        auto& items = items_;
+        __parallel::enumerate(missing.begin(), missing.end(),
+                              [&subnfps, &items, &trsh](size_t idx, size_t)
         {
-            auto& fixedp = sh.transformedShape();
-            auto& orbp = trsh.transformedShape();
-            auto subnfp_r = noFitPolygon<NfpLevel::CONVEX_ONLY>(fixedp, orbp);
-            correctNfpPosition(subnfp_r, sh, trsh);
-            nfps[n] = subnfp_r.first;
+            const Item& sh = items[idx];
+            subnfps[idx] = noFitPolygon<NfpLevel::CONVEX_ONLY>(
+                        sh.transformedShape(), trsh.transformedShape());
         });
 
+        for(auto& dup : duplicates) subnfps[dup.first] = subnfps[dup.second];
+
+        auto orbiter = __itemhash::relativeContour(trsh);
+        for(size_t idx : missing) {
+            auto stationary = __itemhash::relativeContour(items_[idx].get());
+            size_t vcount = sl::contourVertexCount(subnfps[idx].first) +
+                            stationary.size() + orbiter.size();
+            if(nfpcache_vertices_ + vcount > NFPCACHE_MAX_VERTICES) {
+                nfpcache_.clear();
+                nfpcache_vertices_ = 0;
+            }
+            nfpcache_.emplace(keys[idx], __itemhash::Entry<RawShape>{
+                                  std::move(stationary), orbiter, subnfps[idx]});
+            nfpcache_vertices_ += vcount;
+        }
+
+        for(size_t n = 0; n < items_.size(); ++n) {
+            correctNfpPosition(subnfps[n], items_[n].get(), trsh);
+            nfps[n] = std::move(subnfps[n].first);
+        }
+
         return nfp::merge(nfps);
     }
 
@@ -856,8 +979,6 @@ private:
             remlist.insert(remlist.end(), remaining.from, remaining.to);
         }
 
-        size_t itemhash = __itemhash::hash(item);
-
         if(items_.empty()) {
             setInitialPosition(item);
             best_overfit = overfit(item.transformedShape(), bin_);
@@ -870,19 +991,111 @@ private:
             auto initial_rot = item.rotation();
             Vertex final_tr = {0, 0};
             Radians final_rot = initial_rot;
-            Shapes nfps;
 
-            for(auto rot : config_.rotations) {
+            // The pile and the object function do not depend on the rotation
+            // of the new item so they are prepared only once.
+            Shapes pile;
+            pile.reserve(items_.size()+1);
+            // double pile_area = 0;
+            for(Item& mitem : items_) {
+                pile.emplace_back(mitem.transformedShape());
+                // pile_area += mitem.area();
+            }
+
+            auto merged_pile = nfp::merge(pile);
+            auto& bin = bin_;
+            double norm = norm_;
+            auto pbb = sl::boundingBox(merged_pile);
+            auto binbb = sl::boundingBox(bin);
+
+            // This is the kernel part of the object function that is
+            // customizable by the library client
+            std::function<double(const Item&)> _objfunc;
+            if(config_.object_function) _objfunc = config_.object_function;
+            else {
+
+                // Inside check has to be strict if no alignment was enabled
+                std::function<double(const Box&)> ins_check;
+                if(config_.alignment == Config::Alignment::DONT_ALIGN)
+                    ins_check = [&binbb, norm](const Box& fullbb) {
+                        double ret = 0;
+                        if(!sl::isInside(fullbb, binbb))
+                            ret += norm;
+                        return ret;
+                    };
+                else
+                    ins_check = [&bin](const Box& fullbb) {
+                        double miss = overfit(fullbb, bin);
+                        miss = miss > 0? miss : 0;
+                        return std::pow(miss, 2);
+                    };
+
+                _objfunc = [norm, binbb, pbb, ins_check](const Item& item)
+                {
+                    auto ibb = item.boundingBox();
+                    auto fullbb = boundingBox(pbb, ibb);
+
+                    double score = pl::distance(ibb.center(),
+                                                binbb.center());
+                    score /= norm;
 
-                item.translation(initial_tr);
-                item.rotation(initial_rot + rot);
-                item.boundingBox(); // fill the bb cache
+                    score += ins_check(fullbb);
+
+                    return score;
+                };
+            }
+
+            std::launch policy = std::launch::deferred;
+            if(config_.parallel) policy |= std::launch::async;
+
+            if(config_.before_packing)
+                config_.before_packing(merged_pile, items_, remlist);
+
+            // One candidate copy of the item for every rotation. The nfps are
+            // calculated in sequence as they share the nfp cache, each
+            // calculation runs in parallel over the packed items already.
+            const auto& rotations = config_.rotations;
+            std::vector<Item> candidates;
+            std::vector<Shapes> rotnfps(rotations.size());
+            candidates.reserve(rotations.size());
+
+            for(size_t r = 0; r < rotations.size(); ++r) {
+                candidates.emplace_back(item);
+                Item& cand = candidates.back();
+
+                cand.translation(initial_tr);
+                cand.rotation(initial_rot + rotations[r]);
+                cand.boundingBox(); // fill the bb cache
 
                 // place the new item outside of the print bed to make sure
                 // it is disjunct from the current merged pile
-                placeOutsideOfBin(item);
+                placeOutsideOfBin(cand);
+
+                rotnfps[r] = calcnfp({cand, __itemhash::hash(cand)},
+                                     Lvl<MaxNfpLevel::value>());
+            }
+
+            struct RotResult {
+                double score = std::numeric_limits<double>::max();
+                double overfit = std::numeric_limits<double>::max();
+                Vertex tr = {0, 0};
+            };
+
+            std::vector<RotResult> rotresults(rotations.size());
 
-                nfps = calcnfp({item, itemhash}, Lvl<MaxNfpLevel::value>());
+            // The candidate positions for each rotation are evaluated in
+            // parallel, each on its own copy of the item and the pile.
+            std::vector<size_t> rotidx(rotations.size());
+            std::iota(rotidx.begin(), rotidx.end(), 0);
+            __parallel::enumerate(rotidx.begin(), rotidx.end(),
+                                  [this, &candidates, &rotnfps, &rotresults,
+                                   &merged_pile, &_objfunc, &bin, policy]
+                                  (size_t r, size_t)
+            {
+                Item& item = candidates[r];
+                Shapes& nfps = rotnfps[r];
+                RotResult& res = rotresults[r];
+                double& best_overfit = res.overfit;
 
                 auto iv = item.referenceVertex();
 
@@ -896,59 +1109,10 @@ private:
                     ecache.back().accuracy(config_.accuracy);
                 }
 
-                Shapes pile;
-                pile.reserve(items_.size()+1);
-                // double pile_area = 0;
-                for(Item& mitem : items_) {
-                    pile.emplace_back(mitem.transformedShape());
-                    // pile_area += mitem.area();
-                }
-
-                auto merged_pile = nfp::merge(pile);
-                auto& bin = bin_;
-                double norm = norm_;
-                auto pbb = sl::boundingBox(merged_pile);
-                auto binbb = sl::boundingBox(bin);
-
-                // This is the kernel part of the object function that is
-                // customizable by the library client
-                std::function<double(const Item&)> _objfunc;
-                if(config_.object_function) _objfunc = config_.object_function;
-                else {
-
-                    // Inside check has to be strict if no alignment was enabled
-                    std::function<double(const Box&)> ins_check;
-                    if(config_.alignment == Config::Alignment::DONT_ALIGN)
-                        ins_check = [&binbb, norm](const Box& fullbb) {
-                            double ret = 0;
-                            if(!sl::isInside(fullbb, binbb))
-                                ret += norm;
-                            return ret;
-                        };
-                    else
-                        ins_check = [&bin](const Box& fullbb) {
-                            double miss = overfit(fullbb, bin);
-                            miss = miss > 0? miss : 0;
-                            return std::pow(miss, 2);
-                        };
-
-                    _objfunc = [norm, binbb, pbb, ins_check](const Item& item)
-                    {
-                        auto ibb = item.boundingBox();
-                        auto fullbb = boundingBox(pbb, ibb);
-
-                        double score = pl::distance(ibb.center(),
-                                                    binbb.center());
-                        score /= norm;
-
-                        score += ins_check(fullbb);
-
-                        return score;
-                    };
-                }
+                auto pile = merged_pile;
 
                 // Our object function for placement
-                auto rawobjfunc = [_objfunc, iv, startpos]
+                auto rawobjfunc = [&_objfunc, iv, startpos]
                         (Vertex v, Item& itm)
                 {
                     auto d = v - iv;
@@ -965,7 +1129,7 @@ private:
 
                 auto alignment = config_.alignment;
 
-                auto boundaryCheck = [alignment, &merged_pile, &getNfpPoint,
+                auto boundaryCheck = [alignment, &pile, &getNfpPoint,
                         &item, &bin, &iv, &startpos] (const Optimum& o)
                 {
                     auto v = getNfpPoint(o);
@@ -973,9 +1137,9 @@ private:
                     d += startpos;
                     item.translation(d);
 
-                    merged_pile.emplace_back(item.transformedShape());
-                    auto chull = sl::convexHull(merged_pile);
-                    merged_pile.pop_back();
+                    pile.emplace_back(item.transformedShape());
+                    auto chull = sl::convexHull(pile);
+                    pile.pop_back();
 
                     double miss = 0;
                     if(alignment == Config::Alignment::DONT_ALIGN)
@@ -987,11 +1151,6 @@ private:
 
                 Optimum optimum(0, 0);
                 double best_score = std::numeric_limits<double>::max();
-                std::launch policy = std::launch::deferred;
-                if(config_.parallel) policy |= std::launch::async;
-
-                if(config_.before_packing)
-                    config_.before_packing(merged_pile, items_, remlist);
 
                 using OptResult = opt::Result<double>;
                 using OptResults = std::vector<OptResult>;
@@ -1102,13 +1261,23 @@ private:
                     }
                 }
 
-                if( best_score < global_score ) {
+                if(best_score < std::numeric_limits<double>::max()) {
                     auto d = getNfpPoint(optimum) - iv;
                     d += startpos;
-                    final_tr = d;
-                    final_rot = initial_rot + rot;
+                    res.tr = d;
+                    res.score = best_score;
+                }
+            }, policy);
+
+            // Pick the best rotation, the first one of equal scores wins
+            for(size_t r = 0; r < rotations.size(); ++r) {
+                const RotResult& res = rotresults[r];
+                best_overfit = std::min(res.overfit, best_overfit);
+                if( res.score < global_score ) {
+                    final_tr = res.tr;
+                    final_rot = initial_rot + rotations[r];
                     can_pack = true;
-                    global_score = best_score;
+                    global_score = res.score;
                 }
             }
 
@@ -1118,7 +1287,6 @@ private:
 
         if(can_pack) {
             ret = PackResult(item);
-            item_keys_.emplace_back(itemhash);
         } else {
             ret = PackResult(best_overfit);
         }
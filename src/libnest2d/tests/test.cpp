@@ -897,6 +897,161 @@ TEST(GeometryAlgorithms, mergePileWithPolygon) {
     ASSERT_EQ(shapelike::area(result.front()), ref.area());
 }
 
+TEST(GeometryAlgorithms, nfpConvexOnlyIntegerUnit) {
+    using namespace libnest2d;
+    
+    std::vector<std::pair<PolygonImpl, PolygonImpl>> pairs;
+    for(auto& td : nfp_testdata)
+        pairs.emplace_back(td.stationary.transformedShape(),
+                           td.orbiter.transformedShape());
+    
+    // Rotated convex hulls of the printer parts give edges of arbitrary
+    // directions, many of them in the same quadrant.
+    auto& parts = prusaParts();
+    for(size_t i = 0; i + 1 < parts.size(); i += 2) {
+        Item stationary = parts[i], orbiter = parts[i + 1];
+        stationary.rotation(Radians(0.1 * i));
+        orbiter.rotation(Radians(-0.3 * i));
+        pairs.emplace_back(sl::convexHull(stationary.transformedShape()),
+                           sl::convexHull(orbiter.transformedShape()));
+    }
+    
+    for(auto& p : pairs) {
+        auto exact = nfp::nfpConvexOnly<PolygonImpl, LargeInt>(p.first, p.second);
+        auto ref = nfp::nfpConvexOnly<PolygonImpl, boost::rational<LargeInt>>(
+                    p.first, p.second);
+        
+        ASSERT_TRUE(exact.first.Contour == ref.first.Contour);
+        ASSERT_EQ(getX(exact.second), getX(ref.second));
+        ASSERT_EQ(getY(exact.second), getY(ref.second));
+        
+        // The nfp of convex shapes is the convex hull of the differences of
+        // their vertices.
+        PathImpl diffs;
+        for(auto& a : sl::contour(p.first))
+            for(auto& b : sl::contour(p.second))
+                diffs.emplace_back(getX(a) - getX(b), getY(a) - getY(b));
+        
+        double area = std::abs(sl::area(exact.first));
+        double hullarea = std::abs(sl::area(PolygonImpl(sl::convexHull(diffs))));
+        ASSERT_NEAR(area, hullarea, 1e-9 * hullarea);
+    }
+}
+
+TEST(GeometryAlgorithms, nfpCacheSameKeyDifferentContour) {
+    using namespace libnest2d;
+    
+    using Entry = __itemhash::Entry<PolygonImpl>;
+    
+    Rectangle stationary(10, 10), orbiter(20, 5), other(10, 20);
+    
+    // Force all the entries under the same key, as if the hash collided.
+    const __itemhash::Key key = 42;
+    __itemhash::Hash<PolygonImpl> cache;
+    cache.emplace(key, Entry{
+        __itemhash::relativeContour(stationary),
+        __itemhash::relativeContour(orbiter),
+        nfp::noFitPolygon<nfp::NfpLevel::CONVEX_ONLY>(
+            stationary.transformedShape(), orbiter.transformedShape()) });
+    
+    // A translated copy of the same shape is a hit.
+    Rectangle moved(10, 10);
+    moved.translate({100, 50});
+    ASSERT_TRUE(__itemhash::find(cache, key, moved, orbiter) != cache.end());
+    
+    // Different contours under the same key are a miss, be it the stationary
+    // or the orbiting one, and so are the same contours under another key.
+    ASSERT_TRUE(__itemhash::find(cache, key, other, orbiter) == cache.end());
+    ASSERT_TRUE(__itemhash::find(cache, key, stationary, other) == cache.end());
+    ASSERT_TRUE(__itemhash::find(cache, key + 1, stationary, orbiter) == cache.end());
+    
+    auto othernfp = nfp::noFitPolygon<nfp::NfpLevel::CONVEX_ONLY>(
+                other.transformedShape(), orbiter.transformedShape());
+    cache.emplace(key, Entry{ __itemhash::relativeContour(other),
+                              __itemhash::relativeContour(orbiter),
+                              othernfp });
+    
+    // Both entries are found under the same key, each with its own nfp.
+    auto it = __itemhash::find(cache, key, other, orbiter);
+    ASSERT_TRUE(it != cache.end());
+    ASSERT_TRUE(it->second.nfp.first.Contour == othernfp.first.Contour);
+    
+    it = __itemhash::find(cache, key, moved, orbiter);
+    ASSERT_TRUE(it != cache.end());
+    ASSERT_TRUE(__itemhash::sameContour(stationary, it->second.stationary));
+}
+
+TEST(GeometryAlgorithms, NfpPlacerRotations) {
+    using namespace libnest2d;
+    
+    const Coord SCALE = 1000000;
+    
+    std::vector<Item> input;
+    auto& parts = prusaParts();
+    for(size_t i = 0; i < 20 && i < parts.size(); ++i)
+        input.emplace_back(sl::convexHull(parts[i].rawShape()));
+    
+    Box bin(250*SCALE, 210*SCALE);
+    
+    NfpPlacer::Config pconf;
+    pconf.rotations = {0.0, Pi/2.0, Pi, 3*Pi/2};
+    
+    PackGroup result = libnest2d::nest(input, bin, 0, pconf);
+    
+    size_t partsum = 0;
+    for(auto& group : result) {
+        partsum += group.size();
+        
+        // The parts may touch with a rounding error, so the overlaps are
+        // checked by area: the merged pile is as big as the parts together,
+        // up to a square millimeter.
+        nfp::Shapes<PolygonImpl> pile;
+        double area = 0;
+        for(Item& r : group) {
+            pile.emplace_back(r.transformedShape());
+            area += std::abs(r.area());
+        }
+        
+        double mergedarea = 0;
+        for(auto& sh : nfp::merge(pile)) mergedarea += std::abs(sl::area(sh));
+        
+        ASSERT_NEAR(mergedarea, area, double(SCALE) * SCALE);
+        
+        for(Item& r1 : group) {
+            Box bb = r1.boundingBox();
+            ASSERT_GE(getX(bb.minCorner()), getX(bin.minCorner()));
+            ASSERT_GE(getY(bb.minCorner()), getY(bin.minCorner()));
+            ASSERT_LE(getX(bb.maxCorner()), getX(bin.maxCorner()));
+            ASSERT_LE(getY(bb.maxCorner()), getY(bin.maxCorner()));
+            
+            double rot = r1.rotation();
+            ASSERT_TRUE(std::any_of(pconf.rotations.begin(),
+                                    pconf.rotations.end(),
+                                    [rot](const Radians& r) {
+                return std::abs(double(r) - rot) < 1e-9;
+            }));
+        }
+    }
+    
+    ASSERT_EQ(partsum, input.size());
+    
+    // The rotations are evaluated in parallel, the result has to be the same
+    // nevertheless.
+    PackGroup again = libnest2d::nest(input, bin, 0, pconf);
+    
+    ASSERT_EQ(again.size(), result.size());
+    for(size_t b = 0; b < result.size(); ++b) {
+        ASSERT_EQ(again[b].size(), result[b].size());
+        for(size_t i = 0; i < result[b].size(); ++i) {
+            Item& r1 = result[b][i];
+            Item& r2 = again[b][i];
+            ASSERT_EQ(getX(r1.translation()), getX(r2.translation()));
+            ASSERT_EQ(getY(r1.translation()), getY(r2.translation()));
+            ASSERT_DOUBLE_EQ(r1.rotation(), r2.rotation());
+        }
+    }
+}
+
 namespace {
 
 long double refMinAreaBox(const PolygonImpl& p) {    
@@ -108,14 +108,19 @@ void ExtrusionEntityCollection::chained_path_from(Point start_near, ExtrusionEnt
         *retval = *this;
         return;
     }
-    retval->entities.reserve(this->entities.size());
-    retval->orig_indices.reserve(this->entities.size());
+    ExtrusionEntityCollection::chained_path_from(this->entities, start_near, retval, no_reverse, role, orig_indices);
+}
+
+void ExtrusionEntityCollection::chained_path_from(const ExtrusionEntitiesPtr &entities, Point start_near, ExtrusionEntityCollection* retval, bool no_reverse, ExtrusionRole role, std::vector<size_t>* orig_indices)
+{
+    retval->entities.reserve(entities.size());
+    retval->orig_indices.reserve(entities.size());
     
     // if we're asked to return the original indices, build a map
     std::map<ExtrusionEntity*,size_t> indices_map;
     
     ExtrusionEntitiesPtr my_paths;
-    for (ExtrusionEntitiesPtr::const_iterator it = this->entities.begin(); it != this->entities.end(); ++it) {
+    for (ExtrusionEntitiesPtr::const_iterator it = entities.begin(); it != entities.end(); ++it) {
         if (role != erMixed) {
             // The caller wants only paths with a specific extrusion role.
             auto role2 = (*it)->role();
@@ -128,7 +133,7 @@ void ExtrusionEntityCollection::chained_path_from(Point start_near, ExtrusionEnt
 
         ExtrusionEntity* entity = (*it)->clone();
         my_paths.push_back(entity);
-        if (orig_indices != NULL) indices_map[entity] = it - this->entities.begin();
+        if (orig_indices != NULL) indices_map[entity] = it - entities.begin();
     }
     
     Points endpoints;
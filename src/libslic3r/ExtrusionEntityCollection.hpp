@@ -66,6 +66,9 @@ public:
     void chained_path(ExtrusionEntityCollection* retval, bool no_reverse = false, ExtrusionRole role = erMixed, std::vector<size_t>* orig_indices = nullptr) const;
     ExtrusionEntityCollection chained_path_from(Point start_near, bool no_reverse = false, ExtrusionRole role = erMixed) const;
     void chained_path_from(Point start_near, ExtrusionEntityCollection* retval, bool no_reverse = false, ExtrusionRole role = erMixed, std::vector<size_t>* orig_indices = nullptr) const;
+    // Chain extrusion entities not owned by a collection (for example referenced by the G-code generator),
+    // the chained entities are cloned into retval.
+    static void chained_path_from(const ExtrusionEntitiesPtr &entities, Point start_near, ExtrusionEntityCollection* retval, bool no_reverse = false, ExtrusionRole role = erMixed, std::vector<size_t>* orig_indices = nullptr);
     void reverse();
     Point first_point() const { return this->entities.front()->first_point(); }
     Point last_point() const { return this->entities.back()->last_point(); }
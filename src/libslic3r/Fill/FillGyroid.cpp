@@ -29,29 +29,40 @@ static inline double f(double x, double z_sin, double z_cos, bool vertical, bool
     }
 }
 
-static inline Polyline make_wave(
-    const std::vector<Vec2d>& one_period, double width, double height, double offset, double scaleFactor,
-    double z_cos, double z_sin, bool vertical)
+// Repeat one period of the wave over the whole width. The row is the same for all the waves of the same parity,
+// therefore it is calculated just once per layer and then only shifted in Y by make_wave().
+static std::vector<Vec2d> make_row(const std::vector<Vec2d> &one_period, double width)
 {
-    std::vector<Vec2d> points = one_period;
-    double period = points.back()(0);
-    points.pop_back();
-    int n = points.size();
+    std::vector<Vec2d> points;
+    double period = one_period.back()(0);
+    size_t n      = one_period.size() - 1;
+    points.reserve(n * (size_t(std::max(0., width / period)) + 1) + 1);
+    points.assign(one_period.begin(), one_period.end() - 1);
     do {
         points.emplace_back(Vec2d(points[points.size()-n](0) + period, points[points.size()-n](1)));
     } while (points.back()(0) < width);
     points.back()(0) = width;
+    return points;
+}
 
-    // and construct the final polyline to return:
+static inline Polyline make_wave(const std::vector<Vec2d> &row, double height, double offset, double scaleFactor, bool vertical)
+{
+    // Construct the final polyline to return. The loop is free of branches except for the swap,
+    // which is hoisted out of the loop to let the compiler vectorize the conversion.
     Polyline polyline;
-    for (auto& point : points) {
-        point(1) += offset;
-        point(1) = clamp(0., height, double(point(1)));
-        if (vertical)
-            std::swap(point(0), point(1));
-        polyline.points.emplace_back((point * scaleFactor).cast<coord_t>());
+    polyline.points.resize(row.size());
+    Point *out = polyline.points.data();
+    if (vertical) {
+        for (size_t i = 0; i < row.size(); ++ i) {
+            double y = clamp(0., height, row[i](1) + offset);
+            out[i] = Point(coord_t(y * scaleFactor), coord_t(row[i](0) * scaleFactor));
+        }
+    } else {
+        for (size_t i = 0; i < row.size(); ++ i) {
+            double y = clamp(0., height, row[i](1) + offset);
+            out[i] = Point(coord_t(row[i](0) * scaleFactor), coord_t(y * scaleFactor));
+        }
     }
-
     return polyline;
 }
 
@@ -76,12 +87,11 @@ static std::vector<Vec2d> make_one_period(double width, double scaleFactor, doub
         // calculate distance of the point to the line:
         double dist_mm = unscale<double>(scaleFactor) * std::abs(cross2(rp, lp) - cross2(rp - lp, tp)) / lrv.norm();
         if (dist_mm > tolerance) {                               // if the difference from straight line is more than this
-            double x = 0.5f * (points[i-1](0) + points[i](0));
-            points.emplace_back(Vec2d(x, f(x, z_sin, z_cos, vertical, flip)));
-            x = 0.5f * (points[i+1](0) + points[i](0));
-            points.emplace_back(Vec2d(x, f(x, z_sin, z_cos, vertical, flip)));
-            // we added the points to the end, but need them all in order
-            std::sort(points.begin(), points.end(), [](const Vec2d &lhs, const Vec2d &rhs){ return lhs < rhs; });
+            double xl = 0.5f * (points[i-1](0) + points[i](0));
+            double xr = 0.5f * (points[i+1](0) + points[i](0));
+            // Insert the two points in order, the points are sorted by their X coordinate.
+            points.insert(points.begin() + i + 1, Vec2d(xr, f(xr, z_sin, z_cos, vertical, flip)));
+            points.insert(points.begin() + i, Vec2d(xl, f(xl, z_sin, z_cos, vertical, flip)));
             // decrement i so we also check the first newly added point
             --i;
         }
@@ -109,16 +119,18 @@ static Polylines make_gyroid_waves(double gridZ, double density_adjusted, double
         std::swap(width,height);
     }
 
-    std::vector<Vec2d> one_period = make_one_period(width, scaleFactor, z_cos, z_sin, vertical, flip); // creates one period of the waves, so it doesn't have to be recalculated all the time
+    // creates one period of the waves, so it doesn't have to be recalculated all the time
+    std::vector<Vec2d> row = make_row(make_one_period(width, scaleFactor, z_cos, z_sin, vertical, flip), width);
     Polylines result;
+    result.reserve(size_t(std::max(0., (upper_bound - lower_bound) / M_PI)) + 2);
 
     for (double y0 = lower_bound; y0 < upper_bound+EPSILON; y0 += 2*M_PI)           // creates odd polylines
-            result.emplace_back(make_wave(one_period, width, height, y0, scaleFactor, z_cos, z_sin, vertical));
+            result.emplace_back(make_wave(row, height, y0, scaleFactor, vertical));
 
     flip = !flip;                                                                   // even polylines are a bit shifted
-    one_period = make_one_period(width, scaleFactor, z_cos, z_sin, vertical, flip); // updates the one period sample
+    row = make_row(make_one_period(width, scaleFactor, z_cos, z_sin, vertical, flip), width); // updates the one period sample
     for (double y0 = lower_bound + M_PI; y0 < upper_bound+EPSILON; y0 += 2*M_PI)    // creates even polylines
-            result.emplace_back(make_wave(one_period, width, height, y0, scaleFactor, z_cos, z_sin, vertical));
+            result.emplace_back(make_wave(row, height, y0, scaleFactor, vertical));
 
     return result;
 }
@@ -25,6 +25,8 @@
 
 #include <Shiny/Shiny.h>
 
+#include <tbb/task_group.h>
+
 #if 0
 // Enable debugging and asserts, even in the release build.
 #define DEBUG
@@ -570,6 +572,8 @@ void GCode::_do_export(Print &print, FILE *file)
 
     // resets time estimators
     m_normal_time_estimator.reset();
+    // The G-code is fed to the time estimators layer by layer, release the planned moves to keep the memory bounded.
+    m_normal_time_estimator.set_streaming(true);
     m_normal_time_estimator.set_dialect(print.config().gcode_flavor);
     m_silent_time_estimator_enabled = (print.config().gcode_flavor == gcfMarlin) && print.config().silent_mode;
 
@@ -599,6 +603,7 @@ void GCode::_do_export(Print &print, FILE *file)
         if (m_silent_time_estimator_enabled)
         {
             m_silent_time_estimator.reset();
+            m_silent_time_estimator.set_streaming(true);
             m_silent_time_estimator.set_dialect(print.config().gcode_flavor);
 			m_silent_time_estimator.set_max_acceleration((float)print.config().machine_max_acceleration_extruding.values[1]);
 			m_silent_time_estimator.set_retract_acceleration((float)print.config().machine_max_acceleration_retracting.values[1]);
@@ -1102,10 +1107,14 @@ void GCode::_do_export(Print &print, FILE *file)
 
     print.throw_if_canceled();
 
-    // calculates estimated printing time
-    m_normal_time_estimator.calculate_time(false);
-    if (m_silent_time_estimator_enabled)
-        m_silent_time_estimator.calculate_time(false);
+    // calculates estimated printing time, the normal and silent mode estimators are independent
+    {
+        tbb::task_group task_group;
+        if (m_silent_time_estimator_enabled)
+            task_group.run([this] { m_silent_time_estimator.calculate_time(false); });
+        m_normal_time_estimator.calculate_time(false);
+        task_group.wait();
+    }
 
     // Get filament stats.
     print.m_print_statistics.clear();
@@ -2400,7 +2409,7 @@ std::string GCode::extrude_perimeters(const Print &print, const std::vector<Obje
     std::string gcode;
     for (const ObjectByExtruder::Island::Region &region : by_region) {
         m_config.apply(print.regions()[&region - &by_region.front()]->config());
-        for (ExtrusionEntity *ee : region.perimeters.entities)
+        for (const ExtrusionEntity *ee : region.perimeters)
             gcode += this->extrude_entity(*ee, "perimeter", -1., &lower_layer_edge_grid);
     }
     return gcode;
@@ -2412,7 +2421,8 @@ std::string GCode::extrude_infill(const Print &print, const std::vector<ObjectBy
     std::string gcode;
     for (const ObjectByExtruder::Island::Region &region : by_region) {
         m_config.apply(print.regions()[&region - &by_region.front()]->config());
-		ExtrusionEntityCollection chained = region.infills.chained_path_from(m_last_pos, false);
+		ExtrusionEntityCollection chained;
+		ExtrusionEntityCollection::chained_path_from(region.infills, m_last_pos, &chained, false);
         for (ExtrusionEntity *fill : chained.entities) {
             auto *eec = dynamic_cast<ExtrusionEntityCollection*>(fill);
             if (eec) {
@@ -2662,7 +2672,8 @@ std::string GCode::_extrude(const ExtrusionPath &path, std::string description,
         for (const Line &line : path.polyline.lines()) {
             const double line_length = line.length() * SCALING_FACTOR;
             path_length += line_length;
-            gcode += m_writer.extrude_to_xy(
+            m_writer.extrude_to_xy(
+                gcode,
                 this->point_to_gcode(line.b),
                 e_per_mm * line_length,
                 comment);
@@ -2716,7 +2727,7 @@ std::string GCode::travel_to(const Point &point, ExtrusionRole role, std::string
     Lines lines = travel.lines();
     if (! lines.empty()) {
         for (const Line &line : lines)
-    	    gcode += m_writer.travel_to_xy(this->point_to_gcode(line.b), comment);    
+    	    m_writer.travel_to_xy(gcode, this->point_to_gcode(line.b), comment);
         this->set_last_pos(lines.back().b);
     }
     return gcode;
@@ -2884,8 +2895,8 @@ const std::vector<GCode::ObjectByExtruder::Island::Region>& GCode::ObjectByExtru
         // Now we are going to iterate through perimeters and infills and pick ones that are supposed to be printed
         // References are used so that we don't have to repeat the same code
         for (int iter = 0; iter < 2; ++iter) {
-            const ExtrusionEntitiesPtr&         entities     = (iter ? reg.infills.entities : reg.perimeters.entities);
-            ExtrusionEntityCollection&          target_eec   = (iter ? by_region_per_copy_cache.back().infills : by_region_per_copy_cache.back().perimeters);
+            const ExtrusionEntitiesPtr&         entities     = (iter ? reg.infills : reg.perimeters);
+            ExtrusionEntitiesPtr&               target_eec   = (iter ? by_region_per_copy_cache.back().infills : by_region_per_copy_cache.back().perimeters);
             const std::vector<const ExtruderPerCopy*>& overrides   = (iter ? reg.infills_overrides : reg.perimeters_overrides);
 
             // Now the most important thing - which extrusion should we print.
@@ -2894,7 +2905,7 @@ const std::vector<GCode::ObjectByExtruder::Island::Region>& GCode::ObjectByExtru
 
             for (unsigned int i=0;i<entities.size();++i)
                 if (overrides[i]->at(copy) == this_extruder_mark)   // this copy should be printed with this extruder
-                    target_eec.append((*entities[i]));
+                    target_eec.push_back(entities[i]);
         }
     }
     return by_region_per_copy_cache;
@@ -2907,7 +2918,7 @@ const std::vector<GCode::ObjectByExtruder::Island::Region>& GCode::ObjectByExtru
 void GCode::ObjectByExtruder::Island::Region::append(const std::string& type, const ExtrusionEntityCollection* eec, const ExtruderPerCopy* copies_extruder, unsigned int object_copies_num)
 {
     // We are going to manipulate either perimeters or infills, exactly in the same way. Let's create pointers to the proper structure to not repeat ourselves:
-    ExtrusionEntityCollection* perimeters_or_infills = &infills;
+    ExtrusionEntitiesPtr* perimeters_or_infills = &infills;
     std::vector<const ExtruderPerCopy*>* perimeters_or_infills_overrides = &infills_overrides;
 
     if (type == "perimeters") {
@@ -2921,8 +2932,8 @@ void GCode::ObjectByExtruder::Island::Region::append(const std::string& type, co
         }
 
 
-    // First we append the entities, there are eec->entities.size() of them:
-    perimeters_or_infills->append(eec->entities);
+    // First we append the entities, there are eec->entities.size() of them. The entities are referenced, not copied:
+    perimeters_or_infills->insert(perimeters_or_infills->end(), eec->entities.begin(), eec->entities.end());
 
     for (unsigned int i=0;i<eec->entities.size();++i)
         perimeters_or_infills_overrides->push_back(copies_extruder);
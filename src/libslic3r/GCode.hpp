@@ -232,8 +232,10 @@ protected:
         struct Island
         {
             struct Region {
-                ExtrusionEntityCollection perimeters;
-                ExtrusionEntityCollection infills;
+                // The extrusions are not owned, they point into the extrusions of the LayerRegions being exported,
+                // so that the G-code generator does not deep copy the whole layer.
+                ExtrusionEntitiesPtr perimeters;
+                ExtrusionEntitiesPtr infills;
 
                 std::vector<const ExtruderPerCopy*> infills_overrides;
                 std::vector<const ExtruderPerCopy*> perimeters_overrides;
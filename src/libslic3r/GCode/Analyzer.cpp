@@ -10,6 +10,10 @@
 #include "Analyzer.hpp"
 #include "PreviewData.hpp"
 
+#include <unordered_map>
+
+#include <tbb/parallel_for.h>
+
 static const std::string AXIS_STR = "XYZE";
 static const float MMMIN_TO_MMSEC = 1.0f / 60.0f;
 static const float INCHES_TO_MM = 25.4f;
@@ -78,22 +82,46 @@ bool GCodeAnalyzer::Metadata::operator != (const GCodeAnalyzer::Metadata& other)
     return false;
 }
 
-GCodeAnalyzer::GCodeMove::GCodeMove(GCodeMove::EType type, ExtrusionRole extrusion_role, unsigned int extruder_id, double mm3_per_mm, float width, float height, float feedrate, const Vec3d& start_position, const Vec3d& end_position, float delta_extruder, unsigned int cp_color_id/* = 0*/)
-    : type(type)
-    , data(extrusion_role, extruder_id, mm3_per_mm, width, height, feedrate, cp_color_id)
-    , start_position(start_position)
-    , end_position(end_position)
-    , delta_extruder(delta_extruder)
+void GCodeAnalyzer::GCodeMovesList::clear()
 {
+    m_start_positions.clear();
+    m_end_positions.clear();
+    m_delta_extruders.clear();
+    m_data_ids.clear();
+    m_data.clear();
+    m_extruder_offsets.clear();
 }
 
-GCodeAnalyzer::GCodeMove::GCodeMove(GCodeMove::EType type, const GCodeAnalyzer::Metadata& data, const Vec3d& start_position, const Vec3d& end_position, float delta_extruder)
-    : type(type)
-    , data(data)
-    , start_position(start_position)
-    , end_position(end_position)
-    , delta_extruder(delta_extruder)
+void GCodeAnalyzer::GCodeMovesList::shrink_to_fit()
 {
+    m_start_positions.shrink_to_fit();
+    m_end_positions.shrink_to_fit();
+    m_delta_extruders.shrink_to_fit();
+    m_data_ids.shrink_to_fit();
+    m_data.shrink_to_fit();
+    m_extruder_offsets.shrink_to_fit();
+}
+
+void GCodeAnalyzer::GCodeMovesList::push_back(const Metadata& data, const Vec2d& extruder_offset, const Vec3f& start_position, const Vec3f& end_position, float delta_extruder)
+{
+    // starts a new run if the metadata changed since the last move
+    if (m_data.empty() || (m_data.back() != data) || (m_extruder_offsets.back() != extruder_offset))
+    {
+        m_data.emplace_back(data);
+        m_extruder_offsets.emplace_back(extruder_offset);
+    }
+
+    m_start_positions.emplace_back(start_position);
+    m_end_positions.emplace_back(end_position);
+    m_delta_extruders.emplace_back(delta_extruder);
+    m_data_ids.emplace_back((unsigned int)(m_data.size() - 1));
+}
+
+size_t GCodeAnalyzer::GCodeMovesList::memory_used() const
+{
+    return SLIC3R_STDVEC_MEMSIZE(m_start_positions, Vec3f) + SLIC3R_STDVEC_MEMSIZE(m_end_positions, Vec3f) +
+        SLIC3R_STDVEC_MEMSIZE(m_delta_extruders, float) + SLIC3R_STDVEC_MEMSIZE(m_data_ids, unsigned int) +
+        SLIC3R_STDVEC_MEMSIZE(m_data, Metadata) + SLIC3R_STDVEC_MEMSIZE(m_extruder_offsets, Vec2d);
 }
 
 GCodeAnalyzer::GCodeAnalyzer()
@@ -127,7 +155,11 @@ void GCodeAnalyzer::reset()
     _set_start_extrusion(DEFAULT_START_EXTRUSION);
     _reset_axes_position();
 
-    m_moves_map.clear();
+    for (GCodeMovesList& moves : m_moves)
+    {
+        moves.clear();
+        moves.shrink_to_fit();
+    }
     m_extruder_offsets.clear();
 }
 
@@ -172,7 +204,8 @@ void GCodeAnalyzer::_process_gcode_line(GCodeReader&, const GCodeReader::GCodeLi
     {
 #if 0
         // DEBUG ONLY: puts the line back into the gcode
-        m_process_output += line.raw() + "\n";
+        m_process_output.append(line.raw().data(), line.raw().size());
+        m_process_output += "\n";
 #endif
         return;
     }
@@ -182,7 +215,7 @@ void GCodeAnalyzer::_process_gcode_line(GCodeReader&, const GCodeReader::GCodeLi
     _set_start_extrusion(_get_axis_position(E));
 
     // processes 'normal' gcode lines
-    std::string cmd = line.cmd();
+    GCodeReader::string_view cmd = line.cmd();
     if (cmd.length() > 1)
     {
         switch (::toupper(cmd[0]))
@@ -275,7 +308,8 @@ void GCodeAnalyzer::_process_gcode_line(GCodeReader&, const GCodeReader::GCodeLi
     }
 
     // puts the line back into the gcode
-    m_process_output += line.raw() + "\n";
+    m_process_output.append(line.raw().data(), line.raw().size());
+    m_process_output += "\n";
 }
 
 // Returns the new absolute position on the given axis in dependence of the given parameters
@@ -449,20 +483,19 @@ void GCodeAnalyzer::_processM108orM135(const GCodeReader::GCodeLine& line)
     if ((code == 108 && m_gcode_flavor == gcfSailfish)
      || (code == 135 && m_gcode_flavor == gcfMakerWare)) {
 
-        std::string cmd = line.raw();
-        size_t T_pos = cmd.find("T");
-        if (T_pos != std::string::npos) {
-            cmd = cmd.substr(T_pos);
-            _processT(cmd);
-        }
+        GCodeReader::string_view cmd = line.raw();
+        size_t T_pos = cmd.find('T');
+        if (T_pos != GCodeReader::string_view::npos)
+            _processT(cmd.substr(T_pos));
     }
 }
 
-void GCodeAnalyzer::_processT(const std::string& cmd)
+void GCodeAnalyzer::_processT(GCodeReader::string_view cmd)
 {
+    // The view is followed by a word separator, therefore strtol() stops at the end of the command.
     if (cmd.length() > 1)
     {
-        unsigned int id = (unsigned int)::strtol(cmd.substr(1).c_str(), nullptr, 10);
+        unsigned int id = (unsigned int)::strtol(cmd.data() + 1, nullptr, 10);
         if (_get_extruder_id() != id)
         {
             _set_extruder_id(id);
@@ -480,7 +513,7 @@ void GCodeAnalyzer::_processT(const GCodeReader::GCodeLine& line)
 
 bool GCodeAnalyzer::_process_tags(const GCodeReader::GCodeLine& line)
 {
-    std::string comment = line.comment();
+    GCodeReader::string_view comment = line.comment();
 
     // extrusion role tag
     size_t pos = comment.find(Extrusion_Role_Tag);
@@ -517,9 +550,9 @@ bool GCodeAnalyzer::_process_tags(const GCodeReader::GCodeLine& line)
     return false;
 }
 
-void GCodeAnalyzer::_process_extrusion_role_tag(const std::string& comment, size_t pos)
+void GCodeAnalyzer::_process_extrusion_role_tag(GCodeReader::string_view comment, size_t pos)
 {
-    int role = (int)::strtol(comment.substr(pos + Extrusion_Role_Tag.length()).c_str(), nullptr, 10);
+    int role = (int)::strtol(comment.data() + pos + Extrusion_Role_Tag.length(), nullptr, 10);
     if (_is_valid_extrusion_role(role))
         _set_extrusion_role((ExtrusionRole)role);
     else
@@ -528,19 +561,19 @@ void GCodeAnalyzer::_process_extrusion_role_tag(const std::string& comment, size
     }
 }
 
-void GCodeAnalyzer::_process_mm3_per_mm_tag(const std::string& comment, size_t pos)
+void GCodeAnalyzer::_process_mm3_per_mm_tag(GCodeReader::string_view comment, size_t pos)
 {
-    _set_mm3_per_mm(::strtod(comment.substr(pos + Mm3_Per_Mm_Tag.length()).c_str(), nullptr));
+    _set_mm3_per_mm(::strtod(comment.data() + pos + Mm3_Per_Mm_Tag.length(), nullptr));
 }
 
-void GCodeAnalyzer::_process_width_tag(const std::string& comment, size_t pos)
+void GCodeAnalyzer::_process_width_tag(GCodeReader::string_view comment, size_t pos)
 {
-    _set_width((float)::strtod(comment.substr(pos + Width_Tag.length()).c_str(), nullptr));
+    _set_width((float)::strtod(comment.data() + pos + Width_Tag.length(), nullptr));
 }
 
-void GCodeAnalyzer::_process_height_tag(const std::string& comment, size_t pos)
+void GCodeAnalyzer::_process_height_tag(GCodeReader::string_view comment, size_t pos)
 {
-    _set_height((float)::strtod(comment.substr(pos + Height_Tag.length()).c_str(), nullptr));
+    _set_height((float)::strtod(comment.data() + pos + Height_Tag.length(), nullptr));
 }
 
 void GCodeAnalyzer::_set_units(GCodeAnalyzer::EUnits units)
@@ -690,21 +723,18 @@ Vec3d GCodeAnalyzer::_get_end_position() const
 
 void GCodeAnalyzer::_store_move(GCodeAnalyzer::GCodeMove::EType type)
 {
-    // if type non mapped yet, map it
-    TypeToMovesMap::iterator it = m_moves_map.find(type);
-    if (it == m_moves_map.end())
-        it = m_moves_map.insert(TypeToMovesMap::value_type(type, GCodeMovesList())).first;
-
     // store move
-    Vec3d extruder_offset = Vec3d::Zero();
+    Vec2d extruder_offset = Vec2d::Zero();
     unsigned int extruder_id = _get_extruder_id();
     ExtruderOffsetsMap::iterator extr_it = m_extruder_offsets.find(extruder_id);
     if (extr_it != m_extruder_offsets.end())
-        extruder_offset = Vec3d(extr_it->second(0), extr_it->second(1), 0.0);
+        extruder_offset = extr_it->second;
 
-    Vec3d start_position = _get_start_position() + extruder_offset;
-    Vec3d end_position = _get_end_position() + extruder_offset;
-    it->second.emplace_back(type, _get_extrusion_role(), extruder_id, _get_mm3_per_mm(), _get_width(), _get_height(), _get_feedrate(), start_position, end_position, _get_delta_extrusion(), _get_cp_color_id());
+    // the positions are read from the G-code as floats, thus they are stored as floats without any loss
+    Vec3f start_position = _get_start_position().cast<float>();
+    Vec3f end_position(m_state.position[X], m_state.position[Y], m_state.position[Z]);
+    m_moves[type].push_back(Metadata(_get_extrusion_role(), extruder_id, _get_mm3_per_mm(), _get_width(), _get_height(), _get_feedrate(), _get_cp_color_id()),
+        extruder_offset, start_position, end_position, _get_delta_extrusion());
 }
 
 bool GCodeAnalyzer::_is_valid_extrusion_role(int value) const
@@ -714,105 +744,154 @@ bool GCodeAnalyzer::_is_valid_extrusion_role(int value) const
 
 void GCodeAnalyzer::_calc_gcode_preview_extrusion_layers(GCodePreviewData& preview_data, std::function<void()> cancel_callback)
 {
-    struct Helper
+    // Extrusion paths and value ranges of a sequence of moves starting at the same z.
+    struct Chunk
     {
-        static GCodePreviewData::Extrusion::Layer& get_layer_at_z(GCodePreviewData::Extrusion::LayersList& layers, float z)
+        size_t begin;
+        size_t end;
+        float z;
+        // Points of the paths, one path after the other.
+        Points points;
+        // Index of the first point of each path.
+        std::vector<unsigned int> paths_first_point;
+        // Metadata of each path, pointing into the list of moves.
+        std::vector<const Metadata*> paths_data;
+        GCodePreviewData::Range height_range;
+        GCodePreviewData::Range width_range;
+        GCodePreviewData::Range feedrate_range;
+        GCodePreviewData::Range volumetric_rate_range;
+
+        void store_polyline(Polyline& polyline, const Metadata& data)
         {
-            //FIXME this has a terrible time complexity
-            for (GCodePreviewData::Extrusion::Layer& layer : layers)
+            // if the polyline is valid, store it as a new path
+            polyline.remove_duplicate_points();
+            if (polyline.is_valid())
             {
-                // if layer found, return it
-                if (layer.z == z)
-                    return layer;
+                paths_first_point.emplace_back((unsigned int)points.size());
+                paths_data.emplace_back(&data);
+                points.insert(points.end(), polyline.points.begin(), polyline.points.end());
             }
-
-            // if layer not found, create and return it
-            layers.emplace_back(z, ExtrusionPaths());
-            return layers.back();
         }
+    };
+
+    const GCodeMovesList& moves = m_moves[GCodeMove::Extrude];
+    if (moves.empty())
+        return;
+
+    // A polyline never spans moves starting at different z, therefore the moves are split into chunks of constant starting z,
+    // which are processed in parallel.
+    std::vector<Chunk> chunks;
+    for (size_t i = 0; i < moves.size();)
+    {
+        Chunk chunk;
+        chunk.begin = i;
+        chunk.z = (float)moves.start_position(i).z();
+        for (++ i; (i < moves.size()) && ((float)moves.start_position(i).z() == chunk.z); ++ i);
+        chunk.end = i;
+        chunks.emplace_back(std::move(chunk));
+    }
 
-        static void store_polyline(const Polyline& polyline, const Metadata& data, float z, GCodePreviewData& preview_data)
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, chunks.size()),
+        [&moves, &chunks, &cancel_callback](const tbb::blocked_range<size_t>& range)
+    {
+        cancel_callback();
+        for (size_t chunk_id = range.begin(); chunk_id < range.end(); ++ chunk_id)
         {
-            // if the polyline is valid, create the extrusion path from it and store it
-            if (polyline.is_valid())
+            Chunk& chunk = chunks[chunk_id];
+            const Metadata* data = nullptr;
+            Polyline polyline;
+            Vec3d position(FLT_MAX, FLT_MAX, FLT_MAX);
+            float volumetric_rate = FLT_MAX;
+
+            // constructs the polylines while traversing the moves
+            for (size_t i = chunk.begin; i < chunk.end; ++ i)
             {
-                ExtrusionPath path(data.extrusion_role, data.mm3_per_mm, data.width, data.height);
-                path.polyline = polyline;
-                path.feedrate = data.feedrate;
-                path.extruder_id = data.extruder_id;
-                path.cp_color_id = data.cp_color_id;
+                const Metadata& move_data = moves.data(i);
+                Vec3d start_position = moves.start_position(i);
+                Vec3d end_position = moves.end_position(i);
+                float move_volumetric_rate = move_data.feedrate * (float)move_data.mm3_per_mm;
 
-                get_layer_at_z(preview_data.extrusion.layers, z).paths.push_back(path);
-            }
-        }
-    };
+                if ((data == nullptr) || (*data != move_data) || (position != start_position) || (volumetric_rate != move_volumetric_rate))
+                {
+                    // store current polyline
+                    if (data != nullptr)
+                        chunk.store_polyline(polyline, *data);
+
+                    // reset current polyline
+                    polyline = Polyline();
+
+                    // add both vertices of the move
+                    polyline.append(Point(scale_(start_position.x()), scale_(start_position.y())));
+                    polyline.append(Point(scale_(end_position.x()), scale_(end_position.y())));
+
+                    // update current values
+                    data = &move_data;
+                    volumetric_rate = move_volumetric_rate;
+                    chunk.height_range.update_from(move_data.height);
+                    chunk.width_range.update_from(move_data.width);
+                    chunk.feedrate_range.update_from(move_data.feedrate);
+                    chunk.volumetric_rate_range.update_from(volumetric_rate);
+                }
+                else
+                    // append end vertex of the move to current polyline
+                    polyline.append(Point(scale_(end_position.x()), scale_(end_position.y())));
 
-    TypeToMovesMap::iterator extrude_moves = m_moves_map.find(GCodeMove::Extrude);
-    if (extrude_moves == m_moves_map.end())
-        return;
+                // update current values
+                position = end_position;
+            }
 
-    Metadata data;
-    float z = FLT_MAX;
-    Polyline polyline;
-    Vec3d position(FLT_MAX, FLT_MAX, FLT_MAX);
-    float volumetric_rate = FLT_MAX;
-    GCodePreviewData::Range height_range;
-    GCodePreviewData::Range width_range;
-    GCodePreviewData::Range feedrate_range;
-    GCodePreviewData::Range volumetric_rate_range;
+            // store last polyline
+            chunk.store_polyline(polyline, *data);
+        }
+    });
 
-    // to avoid to call the callback too often
-    unsigned int cancel_callback_threshold = (unsigned int)std::max((int)extrude_moves->second.size() / 25, 1);
-    unsigned int cancel_callback_curr = 0;
+    cancel_callback();
 
-    // constructs the polylines while traversing the moves
-    for (const GCodeMove& move : extrude_moves->second)
+    // merges the chunks into layers, in the order of the moves
+    std::map<float, size_t> layer_ids;
+    std::map<GCodePreviewData::Extrusion::PathAttributes, unsigned int> attributes_ids;
+    std::unordered_map<const Metadata*, unsigned int> data_to_attributes_id;
+    for (Chunk& chunk : chunks)
     {
-        // to avoid to call the callback too often
-        cancel_callback_curr = (cancel_callback_curr + 1) % cancel_callback_threshold;
-        if (cancel_callback_curr == 0)
-            cancel_callback();
+        preview_data.ranges.height.update_from(chunk.height_range);
+        preview_data.ranges.width.update_from(chunk.width_range);
+        preview_data.ranges.feedrate.update_from(chunk.feedrate_range);
+        preview_data.ranges.volumetric_rate.update_from(chunk.volumetric_rate_range);
+
+        if (chunk.paths_first_point.empty())
+            continue;
 
-        if ((data != move.data) || (z != move.start_position.z()) || (position != move.start_position) || (volumetric_rate != move.data.feedrate * (float)move.data.mm3_per_mm))
+        auto it = layer_ids.find(chunk.z);
+        if (it == layer_ids.end())
         {
-            // store current polyline
-            polyline.remove_duplicate_points();
-            Helper::store_polyline(polyline, data, z, preview_data);
+            it = layer_ids.insert(std::make_pair(chunk.z, preview_data.extrusion.layers.size())).first;
+            preview_data.extrusion.layers.emplace_back(chunk.z);
+        }
+        GCodePreviewData::Extrusion::Layer& layer = preview_data.extrusion.layers[it->second];
 
-            // reset current polyline
-            polyline = Polyline();
+        for (size_t i = 0; i < chunk.paths_first_point.size(); ++ i)
+        {
+            // finds the index of the path attributes, adds the attributes if not stored yet
+            const Metadata* data = chunk.paths_data[i];
+            auto it_data = data_to_attributes_id.find(data);
+            if (it_data == data_to_attributes_id.end())
+            {
+                GCodePreviewData::Extrusion::PathAttributes attributes(data->extrusion_role, data->extruder_id, data->cp_color_id, data->mm3_per_mm, data->width, data->height, data->feedrate);
+                auto it_attributes = attributes_ids.insert(std::make_pair(attributes, (unsigned int)preview_data.extrusion.paths_attributes.size()));
+                if (it_attributes.second)
+                    preview_data.extrusion.paths_attributes.emplace_back(attributes);
+                it_data = data_to_attributes_id.insert(std::make_pair(data, it_attributes.first->second)).first;
+            }
 
-            // add both vertices of the move
-            polyline.append(Point(scale_(move.start_position.x()), scale_(move.start_position.y())));
-            polyline.append(Point(scale_(move.end_position.x()), scale_(move.end_position.y())));
-
-            // update current values
-            data = move.data;
-            z = (float)move.start_position.z();
-            volumetric_rate = move.data.feedrate * (float)move.data.mm3_per_mm;
-            height_range.update_from(move.data.height);
-            width_range.update_from(move.data.width);
-            feedrate_range.update_from(move.data.feedrate);
-            volumetric_rate_range.update_from(volumetric_rate);
+            Points::const_iterator begin = chunk.points.begin() + chunk.paths_first_point[i];
+            Points::const_iterator end = (i + 1 < chunk.paths_first_point.size()) ? chunk.points.begin() + chunk.paths_first_point[i + 1] : chunk.points.end();
+            layer.add_path(begin, end, it_data->second);
         }
-        else
-            // append end vertex of the move to current polyline
-            polyline.append(Point(scale_(move.end_position.x()), scale_(move.end_position.y())));
 
-        // update current values
-        position = move.end_position;
+        // releases the memory of the chunk as soon as possible
+        chunk.points = Points();
     }
 
-    // store last polyline
-    polyline.remove_duplicate_points();
-    Helper::store_polyline(polyline, data, z, preview_data);
-
-    // updates preview ranges data
-    preview_data.ranges.height.update_from(height_range);
-    preview_data.ranges.width.update_from(width_range);
-    preview_data.ranges.feedrate.update_from(feedrate_range);
-    preview_data.ranges.volumetric_rate.update_from(volumetric_rate_range);
-
     // we need to sort the layers by their z as they can be shuffled in case of sequential prints
     std::sort(preview_data.extrusion.layers.begin(), preview_data.extrusion.layers.end(), [](const GCodePreviewData::Extrusion::Layer& l1, const GCodePreviewData::Extrusion::Layer& l2)->bool { return l1.z < l2.z; });
 }
@@ -830,8 +909,8 @@ void GCodeAnalyzer::_calc_gcode_preview_travel(GCodePreviewData& preview_data, s
         }
     };
 
-    TypeToMovesMap::iterator travel_moves = m_moves_map.find(GCodeMove::Move);
-    if (travel_moves == m_moves_map.end())
+    const GCodeMovesList& moves = m_moves[GCodeMove::Move];
+    if (moves.empty())
         return;
 
     Polyline3 polyline;
@@ -846,20 +925,25 @@ void GCodeAnalyzer::_calc_gcode_preview_travel(GCodePreviewData& preview_data, s
     GCodePreviewData::Range feedrate_range;
 
     // to avoid to call the callback too often
-    unsigned int cancel_callback_threshold = (unsigned int)std::max((int)travel_moves->second.size() / 25, 1);
+    unsigned int cancel_callback_threshold = (unsigned int)std::max((int)moves.size() / 25, 1);
     unsigned int cancel_callback_curr = 0;
 
     // constructs the polylines while traversing the moves
-    for (const GCodeMove& move : travel_moves->second)
+    for (size_t i = 0; i < moves.size(); ++ i)
     {
         cancel_callback_curr = (cancel_callback_curr + 1) % cancel_callback_threshold;
         if (cancel_callback_curr == 0)
             cancel_callback();
 
-        GCodePreviewData::Travel::EType move_type = (move.delta_extruder < 0.0f) ? GCodePreviewData::Travel::Retract : ((move.delta_extruder > 0.0f) ? GCodePreviewData::Travel::Extrude : GCodePreviewData::Travel::Move);
-        GCodePreviewData::Travel::Polyline::EDirection move_direction = ((move.start_position.x() != move.end_position.x()) || (move.start_position.y() != move.end_position.y())) ? GCodePreviewData::Travel::Polyline::Generic : GCodePreviewData::Travel::Polyline::Vertical;
+        const Metadata& move_data = moves.data(i);
+        Vec3d start_position = moves.start_position(i);
+        Vec3d end_position = moves.end_position(i);
+        float delta_extruder = moves.delta_extruder(i);
+
+        GCodePreviewData::Travel::EType move_type = (delta_extruder < 0.0f) ? GCodePreviewData::Travel::Retract : ((delta_extruder > 0.0f) ? GCodePreviewData::Travel::Extrude : GCodePreviewData::Travel::Move);
+        GCodePreviewData::Travel::Polyline::EDirection move_direction = ((start_position.x() != end_position.x()) || (start_position.y() != end_position.y())) ? GCodePreviewData::Travel::Polyline::Generic : GCodePreviewData::Travel::Polyline::Vertical;
 
-        if ((type != move_type) || (direction != move_direction) || (feedrate != move.data.feedrate) || (position != move.start_position) || (extruder_id != move.data.extruder_id))
+        if ((type != move_type) || (direction != move_direction) || (feedrate != move_data.feedrate) || (position != start_position) || (extruder_id != move_data.extruder_id))
         {
             // store current polyline
             polyline.remove_duplicate_points();
@@ -869,21 +953,21 @@ void GCodeAnalyzer::_calc_gcode_preview_travel(GCodePreviewData& preview_data, s
             polyline = Polyline3();
 
             // add both vertices of the move
-            polyline.append(Vec3crd(scale_(move.start_position.x()), scale_(move.start_position.y()), scale_(move.start_position.z())));
-            polyline.append(Vec3crd(scale_(move.end_position.x()), scale_(move.end_position.y()), scale_(move.end_position.z())));
+            polyline.append(Vec3crd(scale_(start_position.x()), scale_(start_position.y()), scale_(start_position.z())));
+            polyline.append(Vec3crd(scale_(end_position.x()), scale_(end_position.y()), scale_(end_position.z())));
         }
         else
             // append end vertex of the move to current polyline
-            polyline.append(Vec3crd(scale_(move.end_position.x()), scale_(move.end_position.y()), scale_(move.end_position.z())));
+            polyline.append(Vec3crd(scale_(end_position.x()), scale_(end_position.y()), scale_(end_position.z())));
 
         // update current values
-        position = move.end_position;
+        position = end_position;
         type = move_type;
-        feedrate = move.data.feedrate;
-        extruder_id = move.data.extruder_id;
-        height_range.update_from(move.data.height);
-        width_range.update_from(move.data.width);
-        feedrate_range.update_from(move.data.feedrate);
+        feedrate = move_data.feedrate;
+        extruder_id = move_data.extruder_id;
+        height_range.update_from(move_data.height);
+        width_range.update_from(move_data.width);
+        feedrate_range.update_from(move_data.feedrate);
     }
 
     // store last polyline
@@ -903,23 +987,24 @@ void GCodeAnalyzer::_calc_gcode_preview_travel(GCodePreviewData& preview_data, s
 
 void GCodeAnalyzer::_calc_gcode_preview_retractions(GCodePreviewData& preview_data, std::function<void()> cancel_callback)
 {
-    TypeToMovesMap::iterator retraction_moves = m_moves_map.find(GCodeMove::Retract);
-    if (retraction_moves == m_moves_map.end())
+    const GCodeMovesList& moves = m_moves[GCodeMove::Retract];
+    if (moves.empty())
         return;
 
     // to avoid to call the callback too often
-    unsigned int cancel_callback_threshold = (unsigned int)std::max((int)retraction_moves->second.size() / 25, 1);
+    unsigned int cancel_callback_threshold = (unsigned int)std::max((int)moves.size() / 25, 1);
     unsigned int cancel_callback_curr = 0;
 
-    for (const GCodeMove& move : retraction_moves->second)
+    for (size_t i = 0; i < moves.size(); ++ i)
     {
         cancel_callback_curr = (cancel_callback_curr + 1) % cancel_callback_threshold;
         if (cancel_callback_curr == 0)
             cancel_callback();
 
         // store position
-        Vec3crd position(scale_(move.start_position.x()), scale_(move.start_position.y()), scale_(move.start_position.z()));
-        preview_data.retraction.positions.emplace_back(position, move.data.width, move.data.height);
+        Vec3d start_position = moves.start_position(i);
+        Vec3crd position(scale_(start_position.x()), scale_(start_position.y()), scale_(start_position.z()));
+        preview_data.retraction.positions.emplace_back(position, moves.data(i).width, moves.data(i).height);
     }
 
     // we need to sort the positions by their z as they can be shuffled in case of sequential prints
@@ -930,23 +1015,24 @@ void GCodeAnalyzer::_calc_gcode_preview_retractions(GCodePreviewData& preview_da
 
 void GCodeAnalyzer::_calc_gcode_preview_unretractions(GCodePreviewData& preview_data, std::function<void()> cancel_callback)
 {
-    TypeToMovesMap::iterator unretraction_moves = m_moves_map.find(GCodeMove::Unretract);
-    if (unretraction_moves == m_moves_map.end())
+    const GCodeMovesList& moves = m_moves[GCodeMove::Unretract];
+    if (moves.empty())
         return;
 
     // to avoid to call the callback too often
-    unsigned int cancel_callback_threshold = (unsigned int)std::max((int)unretraction_moves->second.size() / 25, 1);
+    unsigned int cancel_callback_threshold = (unsigned int)std::max((int)moves.size() / 25, 1);
     unsigned int cancel_callback_curr = 0;
 
-    for (const GCodeMove& move : unretraction_moves->second)
+    for (size_t i = 0; i < moves.size(); ++ i)
     {
         cancel_callback_curr = (cancel_callback_curr + 1) % cancel_callback_threshold;
         if (cancel_callback_curr == 0)
             cancel_callback();
 
         // store position
-        Vec3crd position(scale_(move.start_position.x()), scale_(move.start_position.y()), scale_(move.start_position.z()));
-        preview_data.unretraction.positions.emplace_back(position, move.data.width, move.data.height);
+        Vec3d start_position = moves.start_position(i);
+        Vec3crd position(scale_(start_position.x()), scale_(start_position.y()), scale_(start_position.z()));
+        preview_data.unretraction.positions.emplace_back(position, moves.data(i).width, moves.data(i).height);
     }
 
     // we need to sort the positions by their z as they can be shuffled in case of sequential prints
@@ -959,8 +1045,8 @@ void GCodeAnalyzer::_calc_gcode_preview_unretractions(GCodePreviewData& preview_
 size_t GCodeAnalyzer::memory_used() const
 {
     size_t out = sizeof(*this);
-    for (const std::pair<GCodeMove::EType, GCodeMovesList> &kvp : m_moves_map)
-        out += sizeof(kvp) + SLIC3R_STDVEC_MEMSIZE(kvp.second, GCodeMove);
+    for (const GCodeMovesList& moves : m_moves)
+        out += moves.memory_used();
     out += m_process_output.size();
     return out;
 }
@@ -73,19 +73,39 @@ public:
             Extrude,
             Num_Types
         };
+    };
 
-        EType type;
-        Metadata data;
-        Vec3d start_position;
-        Vec3d end_position;
-        float delta_extruder;
-
-        GCodeMove(EType type, ExtrusionRole extrusion_role, unsigned int extruder_id, double mm3_per_mm, float width, float height, float feedrate, const Vec3d& start_position, const Vec3d& end_position, float delta_extruder, unsigned int cp_color_id = 0);
-        GCodeMove(EType type, const Metadata& data, const Vec3d& start_position, const Vec3d& end_position, float delta_extruder);
+    // Moves of a single type, stored column-wise.
+    // The metadata and the extruder offset change rarely, they are stored once for a run of moves sharing them.
+    // The positions are stored without the extruder offset, exactly as they were read from the G-code (as floats).
+    class GCodeMovesList
+    {
+    public:
+        size_t          size() const { return m_data_ids.size(); }
+        bool            empty() const { return m_data_ids.empty(); }
+        void            clear();
+        void            shrink_to_fit();
+        void            push_back(const Metadata& data, const Vec2d& extruder_offset, const Vec3f& start_position, const Vec3f& end_position, float delta_extruder);
+
+        const Metadata& data(size_t idx) const { return m_data[m_data_ids[idx]]; }
+        Vec3d           start_position(size_t idx) const { return m_start_positions[idx].cast<double>() + this->offset(idx); }
+        Vec3d           end_position(size_t idx) const { return m_end_positions[idx].cast<double>() + this->offset(idx); }
+        float           delta_extruder(size_t idx) const { return m_delta_extruders[idx]; }
+
+        size_t          memory_used() const;
+
+    private:
+        Vec3d           offset(size_t idx) const { const Vec2d &o = m_extruder_offsets[m_data_ids[idx]]; return Vec3d(o(0), o(1), 0.); }
+
+        std::vector<Vec3f>          m_start_positions;
+        std::vector<Vec3f>          m_end_positions;
+        std::vector<float>          m_delta_extruders;
+        // Index into m_data and m_extruder_offsets.
+        std::vector<unsigned int>   m_data_ids;
+        std::vector<Metadata>       m_data;
+        std::vector<Vec2d>          m_extruder_offsets;
     };
 
-    typedef std::vector<GCodeMove> GCodeMovesList;
-    typedef std::map<GCodeMove::EType, GCodeMovesList> TypeToMovesMap;
     typedef std::map<unsigned int, Vec2d> ExtruderOffsetsMap;
 
 private:
@@ -104,7 +124,7 @@ private:
 private:
     State m_state;
     GCodeReader m_parser;
-    TypeToMovesMap m_moves_map;
+    GCodeMovesList m_moves[GCodeMove::Num_Types];
     ExtruderOffsetsMap m_extruder_offsets;
     GCodeFlavor m_gcode_flavor;
 
@@ -174,7 +194,7 @@ private:
     void _processM600(const GCodeReader::GCodeLine& line);
 
     // Processes T line (Select Tool)
-    void _processT(const std::string& command);
+    void _processT(GCodeReader::string_view command);
     void _processT(const GCodeReader::GCodeLine& line);
 
     // Processes the tags
@@ -182,16 +202,16 @@ private:
     bool _process_tags(const GCodeReader::GCodeLine& line);
 
     // Processes extrusion role tag
-    void _process_extrusion_role_tag(const std::string& comment, size_t pos);
+    void _process_extrusion_role_tag(GCodeReader::string_view comment, size_t pos);
 
     // Processes mm3_per_mm tag
-    void _process_mm3_per_mm_tag(const std::string& comment, size_t pos);
+    void _process_mm3_per_mm_tag(GCodeReader::string_view comment, size_t pos);
 
     // Processes width tag
-    void _process_width_tag(const std::string& comment, size_t pos);
+    void _process_width_tag(GCodeReader::string_view comment, size_t pos);
 
     // Processes height tag
-    void _process_height_tag(const std::string& comment, size_t pos);
+    void _process_height_tag(GCodeReader::string_view comment, size_t pos);
 
     void _set_units(EUnits units);
     EUnits _get_units() const;
@@ -1,7 +1,6 @@
 #include "../GCode.hpp"
 #include "CoolingBuffer.hpp"
-#include <boost/algorithm/string/predicate.hpp>
-#include <boost/algorithm/string/replace.hpp>
+#include <algorithm>
 #include <iostream>
 #include <float.h>
 
@@ -285,6 +284,22 @@ std::string CoolingBuffer::process_layer(const std::string &gcode, size_t layer_
     return this->apply_layer_cooldown(gcode, layer_id, layer_time_stretched, per_extruder_adjustments);
 }
 
+// Does the G-code line [begin, end) start with prefix?
+static inline bool starts_with(const char *begin, const char *end, const char *prefix)
+{
+    for (; *prefix != 0; ++ begin, ++ prefix)
+        if (begin == end || *begin != *prefix)
+            return false;
+    return true;
+}
+
+// Does the G-code line [begin, end) contain the marker?
+static inline bool contains(const char *begin, const char *end, const char *marker)
+{
+    const char *marker_end = marker + strlen(marker);
+    return std::search(begin, end, marker, marker_end) != end;
+}
+
 // Parse the layer G-code for the moves, which could be adjusted.
 // Return the list of parsed lines, bucketed by an extruder.
 std::vector<PerExtruderAdjustments> CoolingBuffer::parse_layer_gcode(const std::string &gcode, std::vector<float> &current_pos) const
@@ -321,27 +336,27 @@ std::vector<PerExtruderAdjustments> CoolingBuffer::parse_layer_gcode(const std::
     {
         while (*line_end != '\n' && *line_end != 0)
             ++ line_end;
-        // sline will not contain the trailing '\n'.
-        std::string sline(line_start, line_end);
+        // The line is parsed in place, sline_end points after the last character of the line, it does not include the trailing '\n'.
+        const char *sline_end = line_end;
         // CoolingLine will contain the trailing '\n'.
         if (*line_end == '\n')
             ++ line_end;
         CoolingLine line(0, line_start - gcode.c_str(), line_end - gcode.c_str());
-        if (boost::starts_with(sline, "G0 "))
+        if (starts_with(line_start, sline_end, "G0 "))
             line.type = CoolingLine::TYPE_G0;
-        else if (boost::starts_with(sline, "G1 "))
+        else if (starts_with(line_start, sline_end, "G1 "))
             line.type = CoolingLine::TYPE_G1;
-        else if (boost::starts_with(sline, "G92 "))
+        else if (starts_with(line_start, sline_end, "G92 "))
             line.type = CoolingLine::TYPE_G92;
         if (line.type) {
             // G0, G1 or G92
             // Parse the G-code line.
             std::vector<float> new_pos(current_pos);
-            const char *c = sline.data() + 3;
+            const char *c = line_start + 3;
             for (;;) {
                 // Skip whitespaces.
-                for (; *c == ' ' || *c == '\t'; ++ c);
-                if (*c == 0 || *c == ';')
+                for (; c < sline_end && (*c == ' ' || *c == '\t'); ++ c);
+                if (c == sline_end || *c == ';')
                     break;
                 // Parse the axis.
                 size_t axis = (*c >= 'X' && *c <= 'Z') ? (*c - 'X') :
@@ -357,15 +372,19 @@ std::vector<PerExtruderAdjustments> CoolingBuffer::parse_layer_gcode(const std::
                     }
                 }
                 // Skip this word.
-                for (; *c != ' ' && *c != '\t' && *c != 0; ++ c);
+                for (; c < sline_end && *c != ' ' && *c != '\t'; ++ c);
             }
-            bool external_perimeter = boost::contains(sline, ";_EXTERNAL_PERIMETER");
-            bool wipe               = boost::contains(sline, ";_WIPE");
+            // The cooling markers are G-code comments, search for them starting with the first comment only.
+            // The word loop above may have skipped a comment attached to the last word, as GCodeWriter::set_speed()
+            // writes "G1 F3000;_EXTRUDE_SET_SPEED", therefore the comment is searched for from the line start.
+            const char *comment            = std::find(line_start, sline_end, ';');
+            bool        external_perimeter = contains(comment, sline_end, ";_EXTERNAL_PERIMETER");
+            bool        wipe               = contains(comment, sline_end, ";_WIPE");
             if (external_perimeter)
                 line.type |= CoolingLine::TYPE_EXTERNAL_PERIMETER;
             if (wipe)
                 line.type |= CoolingLine::TYPE_WIPE;
-            if (boost::contains(sline, ";_EXTRUDE_SET_SPEED") && ! wipe) {
+            if (contains(comment, sline_end, ";_EXTRUDE_SET_SPEED") && ! wipe) {
                 line.type |= CoolingLine::TYPE_ADJUSTABLE;
                 active_speed_modifier = adjustment->lines.size();
             }
@@ -411,29 +430,29 @@ std::vector<PerExtruderAdjustments> CoolingBuffer::parse_layer_gcode(const std::
                 }
             }
             current_pos = std::move(new_pos);
-        } else if (boost::starts_with(sline, ";_EXTRUDE_END")) {
+        } else if (starts_with(line_start, sline_end, ";_EXTRUDE_END")) {
             line.type = CoolingLine::TYPE_EXTRUDE_END;
             active_speed_modifier = size_t(-1);
-        } else if (boost::starts_with(sline, toolchange_prefix)) {
+        } else if (starts_with(line_start, sline_end, toolchange_prefix.c_str())) {
             // Switch the tool.
             line.type = CoolingLine::TYPE_SET_TOOL;
-            unsigned int new_extruder = (unsigned int)atoi(sline.c_str() + toolchange_prefix.size());
+            unsigned int new_extruder = (unsigned int)atoi(line_start + toolchange_prefix.size());
             if (new_extruder != current_extruder) {
                 current_extruder = new_extruder;
                 adjustment         = &per_extruder_adjustments[map_extruder_to_per_extruder_adjustment[current_extruder]];
             }
-        } else if (boost::starts_with(sline, ";_BRIDGE_FAN_START")) {
+        } else if (starts_with(line_start, sline_end, ";_BRIDGE_FAN_START")) {
             line.type = CoolingLine::TYPE_BRIDGE_FAN_START;
-        } else if (boost::starts_with(sline, ";_BRIDGE_FAN_END")) {
+        } else if (starts_with(line_start, sline_end, ";_BRIDGE_FAN_END")) {
             line.type = CoolingLine::TYPE_BRIDGE_FAN_END;
-        } else if (boost::starts_with(sline, "G4 ")) {
+        } else if (starts_with(line_start, sline_end, "G4 ")) {
             // Parse the wait time.
             line.type = CoolingLine::TYPE_G4;
-            size_t pos_S = sline.find('S', 3);
-            size_t pos_P = sline.find('P', 3);
+            const char *pos_S = std::find(line_start + 3, sline_end, 'S');
+            const char *pos_P = std::find(line_start + 3, sline_end, 'P');
             line.time = line.time_max = float(
-                (pos_S > 0) ? atof(sline.c_str() + pos_S + 1) :
-                (pos_P > 0) ? atof(sline.c_str() + pos_P + 1) * 0.001 : 0.);
+                (pos_S != sline_end) ? atof(pos_S + 1) :
+                (pos_P != sline_end) ? atof(pos_P + 1) * 0.001 : 0.);
         }
         if (line.type != 0)
             adjustment->lines.emplace_back(std::move(line));
@@ -663,7 +682,8 @@ std::string CoolingBuffer::apply_layer_cooldown(
     }
     // Second generate the adjusted G-code.
     std::string new_gcode;
-    new_gcode.reserve(gcode.size() * 2);
+    // The slow down only shortens the G-code by removing the cooling markers, the fan commands are short.
+    new_gcode.reserve(gcode.size() + 256);
     int  fan_speed          = -1;
     bool bridge_fan_control = false;
     int  bridge_fan_speed   = 0;
@@ -779,13 +799,27 @@ std::string CoolingBuffer::apply_layer_cooldown(
             if (end < line_end) {
                 if (line->type & (CoolingLine::TYPE_ADJUSTABLE | CoolingLine::TYPE_EXTERNAL_PERIMETER | CoolingLine::TYPE_WIPE)) {
                     // Process comments, remove ";_EXTRUDE_SET_SPEED", ";_EXTERNAL_PERIMETER", ";_WIPE"
-                    std::string comment(end, line_end);
-                    boost::replace_all(comment, ";_EXTRUDE_SET_SPEED", "");
-                    if (line->type & CoolingLine::TYPE_EXTERNAL_PERIMETER)
-                        boost::replace_all(comment, ";_EXTERNAL_PERIMETER", "");
-                    if (line->type & CoolingLine::TYPE_WIPE)
-                        boost::replace_all(comment, ";_WIPE", "");
-                    new_gcode += comment;
+                    // without copying the comment into a temporary string.
+                    static const std::string marker_set_speed          = ";_EXTRUDE_SET_SPEED";
+                    static const std::string marker_external_perimeter = ";_EXTERNAL_PERIMETER";
+                    static const std::string marker_wipe               = ";_WIPE";
+                    auto skip_marker = [line_end](const char *c, const std::string &marker) {
+                        return (size_t(line_end - c) >= marker.size() && strncmp(c, marker.c_str(), marker.size()) == 0) ? c + marker.size() : c;
+                    };
+                    for (const char *c = end; c < line_end;) {
+                        // Remove the marker starting at this comment start.
+                        const char *c2 = skip_marker(c, marker_set_speed);
+                        if (c2 == c && (line->type & CoolingLine::TYPE_EXTERNAL_PERIMETER))
+                            c2 = skip_marker(c, marker_external_perimeter);
+                        if (c2 == c && (line->type & CoolingLine::TYPE_WIPE))
+                            c2 = skip_marker(c, marker_wipe);
+                        if (c2 == c) {
+                            // Copy up to the next comment start.
+                            c2 = std::find(c + 1, line_end, ';');
+                            new_gcode.append(c, c2 - c);
+                        }
+                        c = c2;
+                    }
                 } else {
                     // Just attach the rest of the source line.
                     new_gcode.append(end, line_end - end);
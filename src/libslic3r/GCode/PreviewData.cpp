@@ -39,12 +39,57 @@ std::vector<unsigned char> GCodePreviewData::Color::as_bytes() const
     return ret;
 }
 
-GCodePreviewData::Extrusion::Layer::Layer(float z, const ExtrusionPaths& paths)
+GCodePreviewData::Extrusion::PathAttributes::PathAttributes(ExtrusionRole role, unsigned int extruder_id, unsigned int cp_color_id, double mm3_per_mm, float width, float height, float feedrate)
+    : mm3_per_mm(mm3_per_mm)
+    , feedrate(feedrate)
+    , width_um(quantize(width))
+    , height_um(quantize(height))
+    , extruder_id((uint16_t)extruder_id)
+    , cp_color_id((uint16_t)cp_color_id)
+    , role(role)
+{
+}
+
+uint16_t GCodePreviewData::Extrusion::PathAttributes::quantize(float value_mm)
+{
+    return (uint16_t)std::min(65535.0f, std::max(0.0f, std::round(value_mm * 1000.0f)));
+}
+
+bool GCodePreviewData::Extrusion::PathAttributes::operator < (const GCodePreviewData::Extrusion::PathAttributes& other) const
+{
+    if (role != other.role)
+        return role < other.role;
+
+    if (extruder_id != other.extruder_id)
+        return extruder_id < other.extruder_id;
+
+    if (cp_color_id != other.cp_color_id)
+        return cp_color_id < other.cp_color_id;
+
+    if (mm3_per_mm != other.mm3_per_mm)
+        return mm3_per_mm < other.mm3_per_mm;
+
+    if (width_um != other.width_um)
+        return width_um < other.width_um;
+
+    if (height_um != other.height_um)
+        return height_um < other.height_um;
+
+    return feedrate < other.feedrate;
+}
+
+GCodePreviewData::Extrusion::Layer::Layer(float z)
     : z(z)
-    , paths(paths)
 {
 }
 
+void GCodePreviewData::Extrusion::Layer::add_path(Points::const_iterator begin, Points::const_iterator end, unsigned int attributes_id)
+{
+    paths_first_point.emplace_back((unsigned int)points.size());
+    paths_attributes_id.emplace_back(attributes_id);
+    points.insert(points.end(), begin, end);
+}
+
 GCodePreviewData::Travel::Polyline::Polyline(EType type, EDirection direction, float feedrate, unsigned int extruder_id, const Polyline3& polyline)
     : type(type)
     , direction(direction)
@@ -210,11 +255,9 @@ size_t GCodePreviewData::Extrusion::memory_used() const
 {
     size_t out = sizeof(*this);
     out += SLIC3R_STDVEC_MEMSIZE(this->layers, Layer);
-    for (const Layer &layer : this->layers) {
-        out += SLIC3R_STDVEC_MEMSIZE(layer.paths, ExtrusionPath);
-        for (const ExtrusionPath &path : layer.paths)
-			out += SLIC3R_STDVEC_MEMSIZE(path.polyline.points, Point);
-    }
+    for (const Layer &layer : this->layers)
+        out += SLIC3R_STDVEC_MEMSIZE(layer.points, Point) + SLIC3R_STDVEC_MEMSIZE(layer.paths_first_point, unsigned int) + SLIC3R_STDVEC_MEMSIZE(layer.paths_attributes_id, unsigned int);
+    out += SLIC3R_STDVEC_MEMSIZE(this->paths_attributes, PathAttributes);
 	return out;
 }
 
@@ -297,6 +340,7 @@ void GCodePreviewData::reset()
     ranges.feedrate.reset();
     ranges.volumetric_rate.reset();
     extrusion.layers.clear();
+    extrusion.paths_attributes.clear();
     travel.polylines.clear();
     retraction.positions.clear();
     unretraction.positions.clear();
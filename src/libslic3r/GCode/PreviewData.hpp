@@ -85,12 +85,51 @@ public:
         static const std::string Default_Extrusion_Role_Names[Num_Extrusion_Roles];
         static const EViewType Default_View_Type;
 
+        // Attributes of an extrusion path. There are only a few distinct combinations of the attributes in a print,
+        // therefore each combination is stored just once into Extrusion::paths_attributes and the paths refer to it by an index.
+        // The width and height are quantized to 16 bits with a micrometer resolution, so that paths differing
+        // by rounding errors of the G-code share their attributes.
+        struct PathAttributes
+        {
+            double mm3_per_mm;
+            float feedrate;  // mm/s
+            uint16_t width_um;
+            uint16_t height_um;
+            uint16_t extruder_id;
+            uint16_t cp_color_id;
+            ExtrusionRole role;
+
+            PathAttributes(ExtrusionRole role, unsigned int extruder_id, unsigned int cp_color_id, double mm3_per_mm, float width, float height, float feedrate);
+
+            float width() const { return 0.001f * (float)width_um; }   // mm
+            float height() const { return 0.001f * (float)height_um; } // mm
+
+            bool operator < (const PathAttributes& other) const;
+
+            static uint16_t quantize(float value_mm);
+        };
+
+        typedef std::vector<PathAttributes> PathAttributesList;
+
+        // Extrusion paths of a layer. The points of all the paths are stored in a single vector,
+        // the path attributes are referenced by an index into Extrusion::paths_attributes.
         struct Layer
         {
             float z;
-            ExtrusionPaths paths;
-
-            Layer(float z, const ExtrusionPaths& paths);
+            // Points of all the paths of this layer, one path after the other.
+            Points points;
+            // Index of the first point of each path into points. A path ends where the next path starts.
+            std::vector<unsigned int> paths_first_point;
+            // Index of the attributes of each path into Extrusion::paths_attributes.
+            std::vector<unsigned int> paths_attributes_id;
+
+            explicit Layer(float z);
+
+            size_t paths_count() const { return paths_first_point.size(); }
+            void add_path(Points::const_iterator begin, Points::const_iterator end, unsigned int attributes_id);
+            // Range of points of the idx-th path.
+            Points::const_iterator path_begin(size_t idx) const { return points.begin() + paths_first_point[idx]; }
+            Points::const_iterator path_end(size_t idx) const { return (idx + 1 < paths_first_point.size()) ? points.begin() + paths_first_point[idx + 1] : points.end(); }
         };
 
         typedef std::vector<Layer> LayersList;
@@ -99,8 +138,11 @@ public:
         Color role_colors[Num_Extrusion_Roles];
         std::string role_names[Num_Extrusion_Roles];
         LayersList layers;
+        PathAttributesList paths_attributes;
         unsigned int role_flags;
 
+        const PathAttributes& path_attributes(const Layer& layer, size_t idx) const { return paths_attributes[layer.paths_attributes_id[idx]]; }
+
         void set_default();
         bool is_role_flag_set(ExtrusionRole role) const;
 
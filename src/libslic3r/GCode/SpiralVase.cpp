@@ -50,14 +50,20 @@ std::string SpiralVase::process_layer(const std::string &gcode)
     z -= layer_height;
     
     std::string new_gcode;
-    this->_reader.parse_buffer(gcode, [&new_gcode, &z, &layer_height, &total_layer_length]
+    new_gcode.reserve(gcode.size() + gcode.size() / 8);
+    auto append_line = [&new_gcode](const GCodeReader::GCodeLine &line) {
+        GCodeReader::string_view raw = line.raw();
+        new_gcode.append(raw.data(), raw.size());
+        new_gcode += '\n';
+    };
+    this->_reader.parse_buffer(gcode, [&append_line, &z, &layer_height, &total_layer_length]
         (GCodeReader &reader, GCodeReader::GCodeLine line) {
         if (line.cmd_is("G1")) {
             if (line.has_z()) {
                 // If this is the initial Z move of the layer, replace it with a
                 // (redundant) move to the last Z of previous layer.
                 line.set(reader, Z, z);
-                new_gcode += line.raw() + '\n';
+                append_line(line);
                 return;
             } else {
                 float dist_XY = line.dist_XY(reader);
@@ -66,7 +72,7 @@ std::string SpiralVase::process_layer(const std::string &gcode)
                     if (line.extruding(reader)) {
                         z += dist_XY * layer_height / total_layer_length;
                         line.set(reader, Z, z);
-                        new_gcode += line.raw() + '\n';
+                        append_line(line);
                     }
                     return;
                 
@@ -78,7 +84,7 @@ std::string SpiralVase::process_layer(const std::string &gcode)
                 }
             }
         }
-        new_gcode += line.raw() + '\n';
+        append_line(line);
     });
     
     return new_gcode;
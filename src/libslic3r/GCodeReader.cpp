@@ -75,11 +75,8 @@ const char* GCodeReader::parse_line_internal(const char *ptr, GCodeLine &gline,
     // Skip the rest of the line.
     for (; ! is_end_of_line(*c); ++ c);
 
-    // Copy the raw string including the comment, without the trailing newlines.
-    if (c > ptr) {
-        PROFILE_BLOCK(copy_raw_string);
-        gline.m_raw.assign(ptr, c);
-    }
+    // Reference the raw string including the comment, without the trailing newlines.
+    gline.m_raw = string_view(ptr, c - ptr);
 
     // Skip the trailing newlines.
 	if (*c == '\r')
@@ -107,17 +104,9 @@ void GCodeReader::update_coordinates(GCodeLine &gline, std::pair<const char*, co
     }
 }
 
-void GCodeReader::parse_file(const std::string &file, callback_t callback)
-{
-    std::ifstream f(file);
-    std::string line;
-    while (std::getline(f, line))
-        this->parse_line(line, callback);
-}
-
 bool GCodeReader::GCodeLine::has(char axis) const
 {
-    const char *c = m_raw.c_str();
+    const char *c = this->raw().data();
     // Skip the whitespaces.
     c = skip_whitespaces(c);
     // Skip the command.
@@ -139,7 +128,7 @@ bool GCodeReader::GCodeLine::has(char axis) const
 
 bool GCodeReader::GCodeLine::has_value(char axis, float &value) const
 {
-    const char *c = m_raw.c_str();
+    const char *c = this->raw().data();
     // Skip the whitespaces.
     c = skip_whitespaces(c);
     // Skip the command.
@@ -182,16 +171,23 @@ void GCodeReader::GCodeLine::set(const GCodeReader &reader, const Axis axis, con
         match[1] = reader.extrusion_axis();
     }
 
+    // Take ownership of the line, it no longer references the parsed buffer.
+    if (! m_modified) {
+        m_raw_modified.assign(m_raw.data(), m_raw.size());
+        m_modified = true;
+    }
+
+    std::string &raw = m_raw_modified;
     if (this->has(axis)) {
-        size_t pos = m_raw.find(match)+2;
-        size_t end = m_raw.find(' ', pos+1);
-        m_raw = m_raw.replace(pos, end-pos, ss.str());
+        size_t pos = raw.find(match)+2;
+        size_t end = raw.find(' ', pos+1);
+        raw = raw.replace(pos, end-pos, ss.str());
     } else {
-        size_t pos = m_raw.find(' ');
+        size_t pos = raw.find(' ');
         if (pos == std::string::npos)
-            m_raw += std::string(match) + ss.str();
+            raw += std::string(match) + ss.str();
         else
-            m_raw = m_raw.replace(pos, 0, std::string(match) + ss.str());
+            raw = raw.replace(pos, 0, std::string(match) + ss.str());
     }
     m_axis[axis] = new_value;
     m_mask |= 1 << int(axis);
@@ -4,26 +4,36 @@
 #include "libslic3r.h"
 #include <cmath>
 #include <cstdlib>
+#include <fstream>
 #include <functional>
 #include <string>
+#include <boost/utility/string_view.hpp>
 #include "PrintConfig.hpp"
 
 namespace Slic3r {
 
 class GCodeReader {
 public:
+    // Lines, commands and comments are returned as views into the parsed buffer, they are valid during the callback only.
+    // The character following the view is always an end of line character or the zero terminator.
+    typedef boost::string_view string_view;
+
     class GCodeLine {
     public:
         GCodeLine() { reset(); }
-        void reset() { m_mask = 0; memset(m_axis, 0, sizeof(m_axis)); m_raw.clear(); }
+        void reset() { m_mask = 0; memset(m_axis, 0, sizeof(m_axis)); m_raw = string_view("", 0); m_modified = false; }
 
-        const std::string&  raw() const { return m_raw; }
-        const std::string   cmd() const { 
-            const char *cmd = GCodeReader::skip_whitespaces(m_raw.c_str());
-            return std::string(cmd, GCodeReader::skip_word(cmd));
+        // Raw line without the trailing newline. Points into the parsed buffer unless the line was modified by set().
+        string_view         raw() const { return m_modified ? string_view(m_raw_modified) : m_raw; }
+        string_view         cmd() const { 
+            const char *cmd = GCodeReader::skip_whitespaces(this->raw().data());
+            return string_view(cmd, GCodeReader::skip_word(cmd) - cmd);
+        }
+        string_view         comment() const {
+            string_view raw = this->raw();
+            size_t      pos = raw.find(';');
+            return (pos == string_view::npos) ? string_view("", 0) : raw.substr(pos + 1);
         }
-        const std::string   comment() const
-            { size_t pos = m_raw.find(';'); return (pos == std::string::npos) ? "" : m_raw.substr(pos + 1); }
 
         bool  has(Axis axis) const { return (m_mask & (1 << int(axis))) != 0; }
         float value(Axis axis) const { return m_axis[axis]; }
@@ -42,7 +52,7 @@ public:
             return sqrt(x*x + y*y);
         }
         bool cmd_is(const char *cmd_test) const {
-            const char *cmd = GCodeReader::skip_whitespaces(m_raw.c_str());
+            const char *cmd = GCodeReader::skip_whitespaces(this->raw().data());
             size_t len = strlen(cmd_test); 
             return strncmp(cmd, cmd_test, len) == 0 && GCodeReader::is_end_of_word(cmd[len]);
         }
@@ -63,7 +73,10 @@ public:
         float f() const { return m_axis[F]; }
 
     private:
-        std::string      m_raw;
+        string_view      m_raw;
+        // Copy of the raw line owned by this GCodeLine, valid if m_modified is set.
+        std::string      m_raw_modified;
+        bool             m_modified;
         float            m_axis[NUM_AXES];
         uint32_t         m_mask;
         friend class GCodeReader;
@@ -103,7 +116,37 @@ public:
     void parse_line(const std::string &line, Callback callback)
         { GCodeLine gline; this->parse_line(line.c_str(), gline, callback); }
 
-    void parse_file(const std::string &file, callback_t callback);
+    // Parse the file in large blocks, each block is tokenized in place without copying the individual lines.
+    template<typename Callback>
+    void parse_file(const std::string &file, Callback callback)
+    {
+        std::ifstream f(file, std::ios::in | std::ios::binary);
+        std::string   buffer;
+        GCodeLine     gline;
+        // Number of bytes of an incomplete line carried over from the previous block.
+        size_t        num_tail = 0;
+        for (bool eof = false; ! eof;) {
+            buffer.resize(num_tail + file_block_size);
+            f.read(&buffer[num_tail], file_block_size);
+            size_t num_read = size_t(f.gcount());
+            eof = num_read < file_block_size;
+            buffer.resize(num_tail + num_read);
+            // Only complete lines are parsed, the last line of the file does not need to be terminated by a newline.
+            size_t num_complete = buffer.size();
+            if (! eof) {
+                size_t pos = buffer.rfind('\n');
+                num_complete = (pos == std::string::npos) ? 0 : pos + 1;
+            }
+            const char *ptr = buffer.c_str();
+            const char *end = ptr + num_complete;
+            while (ptr < end) {
+                gline.reset();
+                ptr = this->parse_line(ptr, gline, callback);
+            }
+            buffer.erase(0, num_complete);
+            num_tail = buffer.size();
+        }
+    }
 
     float& x()       { return m_position[X]; }
     float  x() const { return m_position[X]; }
@@ -122,6 +165,8 @@ private:
     const char* parse_line_internal(const char *ptr, GCodeLine &gline, std::pair<const char*, const char*> &command);
     void        update_coordinates(GCodeLine &gline, std::pair<const char*, const char*> &command);
 
+    static const size_t file_block_size = 4 * 1024 * 1024;
+
     static bool         is_whitespace(char c)           { return c == ' ' || c == '\t'; }
     static bool         is_end_of_line(char c)          { return c == '\r' || c == '\n' || c == 0; }
     static bool         is_end_of_gcode_line(char c)    { return c == ';' || is_end_of_line(c); }
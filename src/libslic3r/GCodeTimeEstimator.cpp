@@ -1,10 +1,11 @@
 #include "GCodeTimeEstimator.hpp"
 #include "Utils.hpp"
-#include <boost/bind.hpp>
 #include <cmath>
 
 #include <Shiny/Shiny.h>
 
+#include <tbb/parallel_for.h>
+
 #include <boost/nowide/fstream.hpp>
 #include <boost/nowide/cstdio.hpp>
 #include <boost/algorithm/string/predicate.hpp>
@@ -25,6 +26,9 @@ static const float DEFAULT_EXTRUDE_FACTOR_OVERRIDE_PERCENTAGE = 1.0f; // 100 per
 
 static const float PREVIOUS_FEEDRATE_THRESHOLD = 0.0001f;
 
+// Streaming mode: number of blocks accumulated before the planned ones are released.
+static const size_t STREAMING_RELEASE_BLOCKS = 65536;
+
 #if ENABLE_MOVE_STATS
 static const std::string MOVE_TYPE_STR[Slic3r::GCodeTimeEstimator::Block::Num_Types] =
 {
@@ -175,6 +179,7 @@ namespace Slic3r {
 
     GCodeTimeEstimator::GCodeTimeEstimator(EMode mode)
         : m_mode(mode)
+        , m_streaming(false)
     {
         reset();
         set_default();
@@ -202,10 +207,14 @@ namespace Slic3r {
 
     void GCodeTimeEstimator::calculate_time(bool start_from_beginning)
     {
-        PROFILE_FUNC();
         if (start_from_beginning)
         {
+            // The blocks released in streaming mode cannot be replanned.
+            assert(! m_streaming);
+            // Process the pending barriers first to store the color print times, then replan all the blocks at once.
+            _process_barriers();
             _reset_time();
+            m_g1_line_ids.clear();
             m_last_st_synchronized_block_id = -1;
         }
         _calculate_time();
@@ -240,7 +249,9 @@ namespace Slic3r {
     {
         reset();
 
-        m_parser.parse_file(file, boost::bind(&GCodeTimeEstimator::_process_gcode_line, this, _1, _2));
+        m_parser.parse_file(file,
+            [this](GCodeReader &reader, const GCodeReader::GCodeLine &line)
+        { this->_process_gcode_line(reader, line); });
         _calculate_time();
 
         if (m_needs_color_times && (m_color_time_cache != 0.0f))
@@ -303,7 +314,7 @@ namespace Slic3r {
         // buffer line to export only when greater than 64K to reduce writing calls
         std::string export_line;
         char time_line[64];
-		G1LineIdToBlockIdMap::const_iterator it_line_id = m_g1_line_ids.begin();
+		G1LineIdToElapsedTimeMap::const_iterator it_line_id = m_g1_line_ids.begin();
 		while (std::getline(in, gcode_line))
         {
             if (!in.good())
@@ -340,18 +351,18 @@ namespace Slic3r {
 
 					assert(it_line_id == m_g1_line_ids.end() || it_line_id->first >= g1_lines_count);
 
-					const Block *block = nullptr;
+					float elapsed_time = -1.0f;
 					if (it_line_id != m_g1_line_ids.end() && it_line_id->first == g1_lines_count) {
-						if (line.has_e() && it_line_id->second < (unsigned int)m_blocks.size())
-							block = &m_blocks[it_line_id->second];
+						if (line.has_e())
+							elapsed_time = it_line_id->second;
 						++it_line_id;
 					}
 
-					if (block != nullptr && block->elapsed_time != -1.0f) {
-                        float block_remaining_time = m_time - block->elapsed_time;
+					if (elapsed_time != -1.0f) {
+                        float block_remaining_time = m_time - elapsed_time;
                         if (std::abs(last_recorded_time - block_remaining_time) > interval)
                         {
-                            sprintf(time_line, time_mask.c_str(), std::to_string((int)(100.0f * block->elapsed_time / m_time)).c_str(), _get_time_minutes(block_remaining_time).c_str());
+                            sprintf(time_line, time_mask.c_str(), std::to_string((int)(100.0f * elapsed_time / m_time)).c_str(), _get_time_minutes(block_remaining_time).c_str());
                             gcode_line += time_line;
 
                             last_recorded_time = block_remaining_time;
@@ -587,6 +598,16 @@ namespace Slic3r {
         return m_state.e_local_positioning_type;
     }
 
+    void GCodeTimeEstimator::set_streaming(bool streaming)
+    {
+        m_streaming = streaming;
+    }
+
+    bool GCodeTimeEstimator::get_streaming() const
+    {
+        return m_streaming;
+    }
+
     int GCodeTimeEstimator::get_g1_line_id() const
     {
         return m_state.g1_line_id;
@@ -719,7 +740,8 @@ namespace Slic3r {
     {
         size_t out = sizeof(*this);
 		out += SLIC3R_STDVEC_MEMSIZE(this->m_blocks, Block);
-		out += SLIC3R_STDVEC_MEMSIZE(this->m_g1_line_ids, G1LineIdToBlockId);
+		out += SLIC3R_STDVEC_MEMSIZE(this->m_g1_line_ids, G1LineIdToElapsedTime);
+		out += SLIC3R_STDVEC_MEMSIZE(this->m_barriers, Barrier);
         return out;
     }
 
@@ -741,6 +763,7 @@ namespace Slic3r {
         m_g1_line_ids.clear();
 
         m_last_st_synchronized_block_id = -1;
+        m_barriers.clear();
 
         m_needs_color_times = false;
         m_color_times.clear();
@@ -755,19 +778,55 @@ namespace Slic3r {
     void GCodeTimeEstimator::_reset_blocks()
     {
         m_blocks.clear();
+        m_released_blocks = 0;
+        m_release_threshold = STREAMING_RELEASE_BLOCKS;
     }
 
     void GCodeTimeEstimator::_calculate_time()
     {
-        PROFILE_FUNC();
-        _forward_pass();
-        _reverse_pass();
-        _recalculate_trapezoids();
+        _simulate_st_synchronize();
+        _process_barriers();
+    }
 
-        m_time += get_additional_time();
-        m_color_time_cache += get_additional_time();
+    void GCodeTimeEstimator::_process_barriers()
+    {
+        if (m_barriers.empty())
+            return;
+
+        // Plan the segments between the barriers in parallel. The segments do not share any block.
+        tbb::parallel_for(tbb::blocked_range<size_t>(0, m_barriers.size()),
+            [this](const tbb::blocked_range<size_t> &range) {
+            for (size_t i = range.begin(); i < range.end(); ++ i) {
+                int block_begin = (i == 0) ? m_last_st_synchronized_block_id + 1 : m_barriers[i - 1].block_id + 1;
+                int block_end   = m_barriers[i].block_id + 1;
+                _forward_pass(block_begin, block_end);
+                _reverse_pass(block_begin, block_end);
+                _recalculate_trapezoids(block_begin, block_end);
+            }
+        });
+
+        // Accumulate the times serially in the order of the blocks, so that the totals match the serial planning exactly.
+        for (const Barrier &barrier : m_barriers)
+        {
+            _accumulate_time(barrier.block_id);
+
+            // The additional time (dwell, filament exchange) is spent after the moves preceding the barrier.
+            m_time += barrier.additional_time;
+            m_color_time_cache += barrier.additional_time;
 
-        for (int i = m_last_st_synchronized_block_id + 1; i < (int)m_blocks.size(); ++i)
+            if (barrier.color_change && (m_color_time_cache != 0.0f))
+            {
+                m_color_times.push_back(m_color_time_cache);
+                m_color_time_cache = 0.0f;
+            }
+        }
+
+        m_barriers.clear();
+    }
+
+    void GCodeTimeEstimator::_accumulate_time(int last_block_id)
+    {
+        for (int i = m_last_st_synchronized_block_id + 1; i <= last_block_id; ++i)
         {
             Block& block = m_blocks[i];
             float block_time = 0.0f;
@@ -776,6 +835,7 @@ namespace Slic3r {
             block_time += block.deceleration_time();
             m_time += block_time;
             block.elapsed_time = m_time;
+            m_g1_line_ids.emplace_back(G1LineIdToElapsedTimeMap::value_type(block.g1_line_id, m_time));
 
 #if ENABLE_MOVE_STATS
             MovesStatsMap::iterator it = _moves_stats.find(block.move_type);
@@ -789,15 +849,51 @@ namespace Slic3r {
             m_color_time_cache += block_time;
         }
 
-        m_last_st_synchronized_block_id = (int)m_blocks.size() - 1;
-        // The additional time has been consumed (added to the total time), reset it to zero.
-        set_additional_time(0.);
+        m_last_st_synchronized_block_id = std::max(m_last_st_synchronized_block_id, last_block_id);
+    }
+
+    void GCodeTimeEstimator::_release_planned_blocks()
+    {
+        PROFILE_FUNC();
+        // Plan the blocks up to the last barrier.
+        _process_barriers();
+
+        // The forward pass only depends on the preceding blocks. The reverse pass does not modify a block,
+        // which enters at its maximum entry speed after the forward pass, therefore it does not propagate over such a block
+        // and the blocks before it are planned exactly as if all the blocks up to the next barrier were known.
+        // The forward pass is repeated over the blocks after it on the next release, which does not change them.
+        int block_begin = m_last_st_synchronized_block_id + 1;
+        int block_end = (int)m_blocks.size();
+        _forward_pass(block_begin, block_end);
+        int last_block_id = block_end - 1;
+        for (; last_block_id > block_begin; --last_block_id)
+        {
+            const Block& block = m_blocks[last_block_id];
+            if (block.feedrate.entry == block.max_entry_speed)
+                break;
+        }
+        if (last_block_id > block_begin)
+        {
+            _reverse_pass(block_begin, last_block_id + 1);
+            // The exit speed of the last block is only known once the block following it is planned.
+            _recalculate_trapezoids(block_begin, last_block_id + 1, false);
+            _accumulate_time(last_block_id - 1);
+        }
+
+        size_t num_planned = size_t(m_last_st_synchronized_block_id + 1);
+        if (num_planned > 0)
+        {
+            m_blocks.erase(m_blocks.begin(), m_blocks.begin() + num_planned);
+            m_released_blocks += num_planned;
+            m_last_st_synchronized_block_id = -1;
+        }
+        m_release_threshold = m_blocks.size() + STREAMING_RELEASE_BLOCKS;
     }
 
     void GCodeTimeEstimator::_process_gcode_line(GCodeReader&, const GCodeReader::GCodeLine& line)
     {
         PROFILE_FUNC();
-        std::string cmd = line.cmd();
+        GCodeReader::string_view cmd = line.cmd();
         if (cmd.length() > 1)
         {
             switch (::toupper(cmd[0]))
@@ -1031,7 +1127,7 @@ namespace Slic3r {
 
         // calculates block entry feedrate
         float vmax_junction = m_curr.safe_feedrate;
-        if (!m_blocks.empty() && (m_prev.feedrate > PREVIOUS_FEEDRATE_THRESHOLD))
+        if ((!m_blocks.empty() || m_released_blocks > 0) && (m_prev.feedrate > PREVIOUS_FEEDRATE_THRESHOLD))
         {
             bool prev_speed_larger = m_prev.feedrate > block.feedrate.cruise;
             float smaller_speed_factor = prev_speed_larger ? (block.feedrate.cruise / m_prev.feedrate) : (m_prev.feedrate / block.feedrate.cruise);
@@ -1134,8 +1230,11 @@ namespace Slic3r {
 #endif // ENABLE_MOVE_STATS
 
         // adds block to blocks list
+        block.g1_line_id = get_g1_line_id();
         m_blocks.emplace_back(block);
-        m_g1_line_ids.emplace_back(G1LineIdToBlockIdMap::value_type(get_g1_line_id(), (unsigned int)m_blocks.size() - 1));
+
+        if (m_streaming && m_blocks.size() >= m_release_threshold)
+            _release_planned_blocks();
     }
 
     void GCodeTimeEstimator::_processG4(const GCodeReader::GCodeLine& line)
@@ -1383,12 +1482,7 @@ namespace Slic3r {
     {
         PROFILE_FUNC();
         m_needs_color_times = true;
-        _calculate_time();
-        if (m_color_time_cache != 0.0f)
-        {
-            m_color_times.push_back(m_color_time_cache);
-            m_color_time_cache = 0.0f;
-        }
+        _simulate_st_synchronize(true);
     }
 
     void GCodeTimeEstimator::_processM702(const GCodeReader::GCodeLine& line)
@@ -1406,10 +1500,10 @@ namespace Slic3r {
 
     void GCodeTimeEstimator::_processT(const GCodeReader::GCodeLine& line)
     {
-        std::string cmd = line.cmd();
+        GCodeReader::string_view cmd = line.cmd();
         if (cmd.length() > 1)
         {
-            unsigned int id = (unsigned int)::strtol(cmd.substr(1).c_str(), nullptr, 10);
+            unsigned int id = (unsigned int)::strtol(cmd.data() + 1, nullptr, 10);
             if (get_extruder_id() != id)
             {
                 // Specific to the MK3 MMU2: The initial extruder ID is set to -1 indicating
@@ -1422,39 +1516,37 @@ namespace Slic3r {
         }
     }
 
-    void GCodeTimeEstimator::_simulate_st_synchronize()
+    void GCodeTimeEstimator::_simulate_st_synchronize(bool color_change)
     {
         PROFILE_FUNC();
-        _calculate_time();
+        // The planning is postponed to _calculate_time(), where the segments between the barriers are planned in parallel.
+        Barrier barrier;
+        barrier.block_id = (int)m_blocks.size() - 1;
+        // The additional time is consumed by the barrier.
+        barrier.additional_time = get_additional_time();
+        barrier.color_change = color_change;
+        m_barriers.emplace_back(barrier);
+        set_additional_time(0.);
     }
 
-    void GCodeTimeEstimator::_forward_pass()
+    void GCodeTimeEstimator::_forward_pass(int block_begin, int block_end)
     {
-        PROFILE_FUNC();
-        if (m_blocks.size() > 1)
+        for (int i = block_begin; i < block_end - 1; ++i)
         {
-            for (int i = m_last_st_synchronized_block_id + 1; i < (int)m_blocks.size() - 1; ++i)
-            {
-                _planner_forward_pass_kernel(m_blocks[i], m_blocks[i + 1]);
-            }
+            _planner_forward_pass_kernel(m_blocks[i], m_blocks[i + 1]);
         }
     }
 
-    void GCodeTimeEstimator::_reverse_pass()
+    void GCodeTimeEstimator::_reverse_pass(int block_begin, int block_end)
     {
-        PROFILE_FUNC();
-        if (m_blocks.size() > 1)
+        for (int i = block_end - 1; i >= block_begin + 1; --i)
         {
-            for (int i = (int)m_blocks.size() - 1; i >= m_last_st_synchronized_block_id + 2; --i)
-            {
-                _planner_reverse_pass_kernel(m_blocks[i - 1], m_blocks[i]);
-            }
+            _planner_reverse_pass_kernel(m_blocks[i - 1], m_blocks[i]);
         }
     }
 
     void GCodeTimeEstimator::_planner_forward_pass_kernel(Block& prev, Block& curr)
     {
-        PROFILE_FUNC();
         // If the previous block is an acceleration block, but it is not long enough to complete the
         // full speed change within the block, we need to adjust the entry speed accordingly. Entry
         // speeds have already been reset, maximized, and reverse planned by reverse planner.
@@ -1493,13 +1585,12 @@ namespace Slic3r {
         }
     }
 
-    void GCodeTimeEstimator::_recalculate_trapezoids()
+    void GCodeTimeEstimator::_recalculate_trapezoids(int block_begin, int block_end, bool plan_last_block)
     {
-        PROFILE_FUNC();
         Block* curr = nullptr;
         Block* next = nullptr;
 
-        for (int i = m_last_st_synchronized_block_id + 1; i < (int)m_blocks.size(); ++i)
+        for (int i = block_begin; i < block_end; ++i)
         {
             Block& b = m_blocks[i];
 
@@ -1522,7 +1613,7 @@ namespace Slic3r {
         }
 
         // Last/newest block in buffer. Always recalculated.
-        if (next != nullptr)
+        if (plan_last_block && (next != nullptr))
         {
             Block block = *next;
             block.feedrate.exit = next->safe_feedrate;
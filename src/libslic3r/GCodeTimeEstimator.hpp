@@ -156,6 +156,8 @@ namespace Slic3r {
             FeedrateProfile feedrate;
             Trapezoid trapezoid;
             float elapsed_time;
+            // Id of the G1 line this block was created from, used to export the remaining times.
+            unsigned int g1_line_id;
 
             Block();
 
@@ -211,8 +213,8 @@ namespace Slic3r {
         typedef std::map<Block::EMoveType, MoveStats> MovesStatsMap;
 #endif // ENABLE_MOVE_STATS
 
-        typedef std::pair<unsigned int, unsigned int> G1LineIdToBlockId;
-        typedef std::vector<G1LineIdToBlockId> G1LineIdToBlockIdMap;
+        typedef std::pair<unsigned int, float> G1LineIdToElapsedTime;
+        typedef std::vector<G1LineIdToElapsedTime> G1LineIdToElapsedTimeMap;
 
     private:
         EMode m_mode;
@@ -221,10 +223,29 @@ namespace Slic3r {
         Feedrates m_curr;
         Feedrates m_prev;
         BlocksList m_blocks;
-        // Map between g1 line id and blocks id, used to speed up export of remaining times
-        G1LineIdToBlockIdMap m_g1_line_ids;
+        // Map between g1 line id and elapsed time of the planned blocks, used to speed up export of remaining times
+        G1LineIdToElapsedTimeMap m_g1_line_ids;
         // Index of the last block already st_synchronized
         int m_last_st_synchronized_block_id;
+        // In streaming mode the blocks are planned and released as soon as they are out of reach of the planner,
+        // so that the memory consumption does not grow with the length of the print.
+        bool m_streaming;
+        // Number of blocks already released in streaming mode.
+        size_t m_released_blocks;
+        // Size of m_blocks at which the planned blocks will be released.
+        size_t m_release_threshold;
+        // Simulated st_synchronize() calls not processed yet. The blocks between two successive barriers are planned
+        // independently of the other blocks, therefore they are planned in parallel by _calculate_time().
+        struct Barrier
+        {
+            // Index of the last block before the barrier.
+            int block_id;
+            // Additional time consumed at the barrier.
+            float additional_time;
+            // Store the color print time at the barrier (M600).
+            bool color_change;
+        };
+        std::vector<Barrier> m_barriers;
         float m_time; // s
 
         // data to calculate color print times
@@ -247,7 +268,7 @@ namespace Slic3r {
 
         // Calculates the time estimate from the gcode lines added using add_gcode_line() or add_gcode_block()
         // start_from_beginning:
-        // if set to true all blocks will be used to calculate the time estimate,
+        // if set to true all blocks will be used to calculate the time estimate (not supported in streaming mode),
         // if set to false only the blocks not yet processed will be used and the calculated time will be added to the current calculated time
         void calculate_time(bool start_from_beginning);
 
@@ -320,6 +341,11 @@ namespace Slic3r {
         void set_e_local_positioning_type(EPositioningType type);
         EPositioningType get_e_local_positioning_type() const;
 
+        // In streaming mode the blocks are released once planned, keeping the memory consumption bounded.
+        // The estimated times are the same as in the default mode, but calculate_time(true) cannot be used.
+        void set_streaming(bool streaming);
+        bool get_streaming() const;
+
         int get_g1_line_id() const;
         void increment_g1_line_id();
         void reset_g1_line_id();
@@ -433,15 +459,23 @@ namespace Slic3r {
         void _processT(const GCodeReader::GCodeLine& line);
 
         // Simulates firmware st_synchronize() call
-        void _simulate_st_synchronize();
-
-        void _forward_pass();
-        void _reverse_pass();
+        void _simulate_st_synchronize(bool color_change = false);
+        // Plans the blocks between the barriers and accumulates their times in the order of the barriers.
+        void _process_barriers();
+        // Accumulates the times of the planned blocks following m_last_st_synchronized_block_id up to last_block_id (inclusive).
+        void _accumulate_time(int last_block_id);
+        // Streaming mode: plans the blocks, which cannot be influenced by the blocks to come, and releases them.
+        void _release_planned_blocks();
+
+        // Plan the blocks <block_begin, block_end). The range is delimited by barriers, it is planned independently of the other blocks.
+        void _forward_pass(int block_begin, int block_end);
+        void _reverse_pass(int block_begin, int block_end);
 
         void _planner_forward_pass_kernel(Block& prev, Block& curr);
         void _planner_reverse_pass_kernel(Block& curr, Block& next);
 
-        void _recalculate_trapezoids();
+        // If plan_last_block is false, the last block of the range is not planned, as its exit speed is not known yet.
+        void _recalculate_trapezoids(int block_begin, int block_end, bool plan_last_block = true);
 
         // Returns the given time is seconds in format DDd HHh MMm SSs
         static std::string _get_time_dhms(float time_in_secs);
@@ -3,6 +3,9 @@
 #include <iomanip>
 #include <iostream>
 #include <map>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
 #include <assert.h>
 
 #define FLAVOR_IS(val) this->config.gcode_flavor == val
@@ -14,6 +17,42 @@
 
 namespace Slic3r {
 
+// Append a number to the G-code the same way std::fixed << std::setprecision(DECIMALS) would, but without
+// a locale aware stream. The digits are generated from the value rounded to a fixed point integer. If the value
+// is too close to a rounding tie for the fixed point rounding to be trusted, or if it is out of range, it is
+// formatted by printf, which rounds the exact binary value the same way the stream does.
+template<int DECIMALS>
+static inline void append_fixed(std::string &out, double v)
+{
+    static const double scales[] = { 1., 10., 100., 1000., 10000., 100000. };
+    static_assert(DECIMALS > 0 && DECIMALS <= 5, "Unsupported number of decimals");
+    double scaled = std::abs(v) * scales[DECIMALS];
+    double rounded = std::floor(scaled + 0.5);
+    if (! (scaled < 1e9) || std::abs(scaled - std::floor(scaled) - 0.5) < 1e-6) {
+        char buf[64];
+        int  len = snprintf(buf, sizeof(buf), "%.*f", DECIMALS, v);
+        out.append(buf, len);
+        return;
+    }
+    char      buf[32];
+    char     *end = buf + sizeof(buf);
+    char     *p   = end;
+    uint64_t  n   = uint64_t(rounded);
+    for (int i = 0; i < DECIMALS; ++ i, n /= 10)
+        *(-- p) = char('0' + n % 10);
+    *(-- p) = '.';
+    do {
+        *(-- p) = char('0' + n % 10);
+        n /= 10;
+    } while (n > 0);
+    if (std::signbit(v))
+        *(-- p) = '-';
+    out.append(p, end);
+}
+
+static inline void append_xyzf(std::string &out, double v) { append_fixed<3>(out, v); }
+static inline void append_e(std::string &out, double v) { append_fixed<5>(out, v); }
+
 void GCodeWriter::apply_print_config(const PrintConfig &print_config)
 {
     this->config.apply(print_config, true);
@@ -277,17 +316,28 @@ std::string GCodeWriter::set_speed(double F, const std::string &comment, const s
 }
 
 std::string GCodeWriter::travel_to_xy(const Vec2d &point, const std::string &comment)
+{
+    std::string gcode;
+    this->travel_to_xy(gcode, point, comment);
+    return gcode;
+}
+
+void GCodeWriter::travel_to_xy(std::string &out, const Vec2d &point, const std::string &comment)
 {
     m_pos(0) = point(0);
     m_pos(1) = point(1);
     
-    std::ostringstream gcode;
-    gcode << "G1 X" << XYZF_NUM(point(0))
-          <<   " Y" << XYZF_NUM(point(1))
-          <<   " F" << XYZF_NUM(this->config.travel_speed.value * 60.0);
-    COMMENT(comment);
-    gcode << "\n";
-    return gcode.str();
+    out += "G1 X";
+    append_xyzf(out, point(0));
+    out += " Y";
+    append_xyzf(out, point(1));
+    out += " F";
+    append_xyzf(out, this->config.travel_speed.value * 60.0);
+    if (this->config.gcode_comments && ! comment.empty()) {
+        out += " ; ";
+        out += comment;
+    }
+    out += '\n';
 }
 
 std::string GCodeWriter::travel_to_xyz(const Vec3d &point, const std::string &comment)
@@ -359,18 +409,30 @@ bool GCodeWriter::will_move_z(double z) const
 }
 
 std::string GCodeWriter::extrude_to_xy(const Vec2d &point, double dE, const std::string &comment)
+{
+    std::string gcode;
+    this->extrude_to_xy(gcode, point, dE, comment);
+    return gcode;
+}
+
+void GCodeWriter::extrude_to_xy(std::string &out, const Vec2d &point, double dE, const std::string &comment)
 {
     m_pos(0) = point(0);
     m_pos(1) = point(1);
     m_extruder->extrude(dE);
     
-    std::ostringstream gcode;
-    gcode << "G1 X" << XYZF_NUM(point(0))
-          <<   " Y" << XYZF_NUM(point(1))
-          <<    " " << m_extrusion_axis << E_NUM(m_extruder->E());
-    COMMENT(comment);
-    gcode << "\n";
-    return gcode.str();
+    out += "G1 X";
+    append_xyzf(out, point(0));
+    out += " Y";
+    append_xyzf(out, point(1));
+    out += ' ';
+    out += m_extrusion_axis;
+    append_e(out, m_extruder->E());
+    if (this->config.gcode_comments && ! comment.empty()) {
+        out += " ; ";
+        out += comment;
+    }
+    out += '\n';
 }
 
 std::string GCodeWriter::extrude_to_xyz(const Vec3d &point, double dE, const std::string &comment)
@@ -61,6 +61,10 @@ public:
     bool        will_move_z(double z) const;
     std::string extrude_to_xy(const Vec2d &point, double dE, const std::string &comment = std::string());
     std::string extrude_to_xyz(const Vec3d &point, double dE, const std::string &comment = std::string());
+    // Variants of travel_to_xy() and extrude_to_xy() appending the G-code to the out buffer.
+    // The numbers are formatted without streams, these are the hot paths of the G-code export.
+    void        travel_to_xy(std::string &out, const Vec2d &point, const std::string &comment = std::string());
+    void        extrude_to_xy(std::string &out, const Vec2d &point, double dE, const std::string &comment = std::string());
     std::string retract(bool before_wipe = false);
     std::string retract_for_toolchange(bool before_wipe = false);
     std::string unretract();
@@ -100,7 +100,7 @@ ExPolygons Layer::merged(float offset_scaled) const
 // Here the perimeters are created cummulatively for all layer regions sharing the same parameters influencing the perimeters.
 // The perimeter paths and the thin fills (ExtrusionEntityCollection) are assigned to the first compatible layer region.
 // The resulting fill surface is split back among the originating regions.
-void Layer::make_perimeters()
+void Layer::make_perimeters(MedialAxisCache *medial_axis_cache)
 {
     BOOST_LOG_TRIVIAL(trace) << "Generating perimeters for layer " << this->id();
     
@@ -138,7 +138,7 @@ void Layer::make_perimeters()
         
         if (layerms.size() == 1) {  // optimization
             (*layerm)->fill_surfaces.surfaces.clear();
-            (*layerm)->make_perimeters((*layerm)->slices, &(*layerm)->fill_surfaces);
+            (*layerm)->make_perimeters((*layerm)->slices, &(*layerm)->fill_surfaces, medial_axis_cache);
             (*layerm)->fill_expolygons = to_expolygons((*layerm)->fill_surfaces.surfaces);
         } else {
             SurfaceCollection new_slices;
@@ -155,7 +155,7 @@ void Layer::make_perimeters()
             
             // make perimeters
             SurfaceCollection fill_surfaces;
-            (*layerm)->make_perimeters(new_slices, &fill_surfaces);
+            (*layerm)->make_perimeters(new_slices, &fill_surfaces, medial_axis_cache);
 
             // assign fill_surfaces to each layer
             if (!fill_surfaces.surfaces.empty()) { 
@@ -14,6 +14,7 @@ namespace Slic3r {
 class Layer;
 class PrintRegion;
 class PrintObject;
+class MedialAxisCache;
 
 class LayerRegion
 {
@@ -61,7 +62,7 @@ public:
     Flow    flow(FlowRole role, bool bridge = false, double width = -1) const;
     void    slices_to_fill_surfaces_clipped();
     void    prepare_fill_surfaces();
-    void    make_perimeters(const SurfaceCollection &slices, SurfaceCollection* fill_surfaces);
+    void    make_perimeters(const SurfaceCollection &slices, SurfaceCollection* fill_surfaces, MedialAxisCache *medial_axis_cache = nullptr);
     void    process_external_surfaces(const Layer* lower_layer);
     double  infill_area_threshold() const;
     // Trim surfaces by trimming polygons. Used by the elephant foot compensation at the 1st layer.
@@ -134,7 +135,7 @@ public:
         for (const LayerRegion *layerm : m_regions) if (layerm->slices.any_bottom_contains(item)) return true;
         return false;
     }
-    void                    make_perimeters();
+    void                    make_perimeters(MedialAxisCache *medial_axis_cache = nullptr);
     void                    make_fills();
 
     void                    export_region_slices_to_svg(const char *path) const;
@@ -11,7 +11,6 @@
 
 #include <boost/geometry/index/rtree.hpp>
 #include <boost/multiprecision/integer.hpp>
-#include <boost/rational.hpp>
 
 namespace libnest2d {
 #if !defined(_MSC_VER) && defined(__SIZEOF_INT128__) && !defined(__APPLE__)
@@ -20,7 +19,6 @@ using LargeInt = __int128;
 using LargeInt = boost::multiprecision::int128_t;
 template<> struct _NumTag<LargeInt> { using Type = ScalarTag; };
 #endif
-template<class T> struct _NumTag<boost::rational<T>> { using Type = RationalTag; };
 
 namespace nfp {
 
@@ -29,7 +27,7 @@ struct NfpImpl<S, NfpLevel::CONVEX_ONLY>
 {
     NfpResult<S> operator()(const S &sh, const S &other)
     {
-        return nfpConvexOnly<S, boost::rational<LargeInt>>(sh, other);
+        return nfpConvexOnly<S, LargeInt>(sh, other);
     }
 };
 
@@ -403,6 +401,16 @@ public:
         m_pck.configure(m_pconf);
     }
 
+    // Try n rotations of each item, evenly spaced over the full circle.
+    inline void rotations(unsigned n) {
+        n = std::max(n, 1u);
+        m_pconf.rotations.clear();
+        for(unsigned i = 0; i < n; ++i)
+            m_pconf.rotations.emplace_back(2 * PI * i / n);
+
+        m_pck.configure(m_pconf);
+    }
+
     bool is_colliding(const Item& item) {
         if(m_rtree.empty()) return false;
         std::vector<SpatElement> result;
@@ -563,6 +571,164 @@ public:
     }
 };
 
+// Fast arranger for plates with hundreds of items. The items are packed by the
+// bounding boxes of their convex hulls with the bottom-left skyline heuristic:
+// they are sorted by decreasing height and each one is put to the lowest, then
+// leftmost position on the skyline of the items already in the bin. The piles
+// are less dense than with the nfp placer for irregular shapes, but there is
+// no polygon clipping or optimization involved at all.
+class SkylineArranger {
+public:
+    using Distance = TCoord<PointImpl>;
+
+private:
+    // A horizontal segment of the skyline, relative to the bin's min corner.
+    // The segments of a skyline are sorted by x and cover the whole bin width.
+    struct Segment { Coord x, y, w; };
+    using Skyline = std::vector<Segment>;
+
+    Box m_bin;
+    Distance m_dist;
+    std::function<void(unsigned)> m_progress;
+    std::function<bool(void)> m_stopcond;
+
+    // Find the lowest, then leftmost position for a w x h rectangle on the
+    // skyline. Returns false if the rectangle does not fit into the bin.
+    bool fit(const Skyline& sky, Coord w, Coord h, Coord& x, Coord& y) const
+    {
+        bool found = false;
+        for(size_t i = 0; i < sky.size(); ++i) {
+            Coord sx = sky[i].x, right = sx + w;
+            if(right > m_bin.width()) break;
+
+            Coord sy = 0;
+            for(size_t j = i; j < sky.size() && sky[j].x < right; ++j)
+                sy = std::max(sy, sky[j].y);
+
+            if(sy + h > m_bin.height()) continue;
+
+            if(!found || sy < y) { x = sx; y = sy; found = true; }
+        }
+
+        return found;
+    }
+
+    // Raise the skyline over [x, x + w) to y.
+    static void raise(Skyline& sky, Coord x, Coord w, Coord y)
+    {
+        Coord right = x + w;
+        Skyline out; out.reserve(sky.size() + 2);
+
+        bool inserted = false;
+        for(const Segment& s : sky) {
+            Coord sright = s.x + s.w;
+            if(sright <= x) { out.emplace_back(s); continue; }
+
+            if(s.x < x) out.push_back({s.x, s.y, x - s.x});
+            if(!inserted) { out.push_back({x, y, w}); inserted = true; }
+
+            Coord from = std::max(s.x, right);
+            if(sright > from) out.push_back({from, s.y, sright - from});
+        }
+
+        // Merge the neighbouring segments of the same height
+        sky.clear();
+        for(const Segment& s : out) {
+            if(!sky.empty() && sky.back().y == s.y) sky.back().w += s.w;
+            else sky.emplace_back(s);
+        }
+    }
+
+public:
+
+    SkylineArranger(const Box& bin, Distance dist,
+                    std::function<void(unsigned)> progressind,
+                    std::function<bool(void)> stopcond):
+        m_bin(bin), m_dist(dist), m_progress(progressind),
+        m_stopcond(stopcond) {}
+
+    template<class It> IndexedPackGroup operator()(It from, It to)
+    {
+        std::vector<std::reference_wrapper<Item>> items(from, to);
+
+        // The items are placed by their bounding boxes grown by the minimum
+        // distance, which is split between the two neighbours.
+        std::vector<Box> bbs; bbs.reserve(items.size());
+        for(Item& itm : items) bbs.emplace_back(itm.boundingBox());
+
+        std::vector<unsigned> order(items.size());
+        std::iota(order.begin(), order.end(), 0);
+        std::stable_sort(order.begin(), order.end(),
+                         [&bbs](unsigned i1, unsigned i2) {
+            const Box& b1 = bbs[i1]; const Box& b2 = bbs[i2];
+            return b1.height() == b2.height() ? b1.width() > b2.width() :
+                                                b1.height() > b2.height();
+        });
+
+        std::vector<Skyline> skylines;
+        IndexedPackGroup result;
+        unsigned remaining = unsigned(items.size());
+        Coord half = m_dist / 2;
+
+        for(unsigned idx : order) {
+            if(m_stopcond && m_stopcond()) break;
+
+            Item& itm = items[idx];
+            const Box& bb = bbs[idx];
+            Coord w = bb.width() + m_dist, h = bb.height() + m_dist;
+            Coord x = 0, y = 0;
+
+            // The first bin where the item fits, a new one if none
+            size_t b = 0;
+            while(b < skylines.size() && !fit(skylines[b], w, h, x, y)) ++b;
+
+            bool fits = b < skylines.size();
+            if(!fits) {
+                Skyline sky = { Segment{0, 0, m_bin.width()} };
+                fits = fit(sky, w, h, x, y);
+                if(fits) {
+                    skylines.emplace_back(std::move(sky));
+                    result.emplace_back();
+                }
+            }
+
+            // Items not fitting even into an empty bin are left untouched
+            if(fits) {
+                raise(skylines[b], x, w, y + h);
+
+                PointImpl d = m_bin.minCorner() + PointImpl{x + half, y + half};
+                itm.translate(d - bb.minCorner());
+                result[b].emplace_back(idx, itm);
+            }
+
+            if(m_progress) m_progress(--remaining);
+        }
+
+        // Center each pile in the bin, as the nfp arranger does
+        for(auto& group : result) {
+            if(group.empty()) continue;
+
+            Box pilebb = group.front().second.get().boundingBox();
+            for(auto& r : group) {
+                Box ibb = r.second.get().boundingBox();
+                pilebb = Box({std::min(getX(pilebb.minCorner()),
+                                       getX(ibb.minCorner())),
+                              std::min(getY(pilebb.minCorner()),
+                                       getY(ibb.minCorner()))},
+                             {std::max(getX(pilebb.maxCorner()),
+                                       getX(ibb.maxCorner())),
+                              std::max(getY(pilebb.maxCorner()),
+                                       getY(ibb.maxCorner()))});
+            }
+
+            PointImpl d = m_bin.center() - pilebb.center();
+            for(auto& r : group) r.second.get().translate(d);
+        }
+
+        return result;
+    }
+};
+
 // A container which stores a pointer to the 3D object and its projected
 // 2D shape from top view.
 using ShapeData2D = std::vector<std::pair<Slic3r::ModelInstance*, Item>>;
@@ -796,7 +962,10 @@ bool arrange(Model &model,              // The model with the geometries
 
              // Controlling callbacks.
              std::function<void (unsigned)> progressind,
-             std::function<bool ()> stopcondition)
+             std::function<bool ()> stopcondition,
+
+             // Number of candidate rotations for each item.
+             unsigned rotations)
 {
     bool ret = true;
     
@@ -816,6 +985,7 @@ bool arrange(Model &model,              // The model with the geometries
     IndexedPackGroup result;
 
     // If there is no hint about the shape, we will try to guess
+    ArrangeMode mode = bedhint.mode;
     if(bedhint.type == BedShapeType::WHO_KNOWS) bedhint = bedShape(bed);
 
     BoundingBox bbb(bed);
@@ -831,11 +1001,29 @@ bool arrange(Model &model,              // The model with the geometries
                      {libnest2d::Coord{bbb.max(0)} + md,
                       libnest2d::Coord{bbb.max(1)} + md});
 
-    switch(bedhint.type) {
+    // The skyline needs a rectangular bin, which only the box shaped and the
+    // circular beds provide.
+    if(mode == ArrangeMode::SKYLINE &&
+       (bedhint.type == BedShapeType::BOX ||
+        bedhint.type == BedShapeType::CIRCLE)) {
+        Box skybin = binbb;
+
+        // Use the square inscribed into a circular bed
+        if(bedhint.type == BedShapeType::CIRCLE) {
+            auto c = bedhint.shape.circ;
+            auto a = static_cast<Coord>(c.radius() / std::sqrt(2.)) + md;
+            skybin = Box({c.center()(0) - a, c.center()(1) - a},
+                         {c.center()(0) + a, c.center()(1) + a});
+        }
+
+        SkylineArranger arrange(skybin, min_obj_distance, progressind, cfn);
+        result = arrange(shapes.begin(), shapes.end());
+    } else switch(bedhint.type) {
     case BedShapeType::BOX: {
 
         // Create the arranger for the box shaped bed
         AutoArranger<Box> arrange(binbb, min_obj_distance, progressind, cfn);
+        arrange.rotations(rotations);
 
         // Arrange and return the items with their respective indices within the
         // input sequence.
@@ -848,6 +1036,7 @@ bool arrange(Model &model,              // The model with the geometries
         auto cc = to_lnCircle(c);
 
         AutoArranger<lnCircle> arrange(cc, min_obj_distance, progressind, cfn);
+        arrange.rotations(rotations);
         result = arrange(shapes.begin(), shapes.end());
         break;
     }
@@ -860,6 +1049,7 @@ bool arrange(Model &model,              // The model with the geometries
         P irrbed = sl::create<PolygonImpl>(std::move(ctour));
 
         AutoArranger<P> arrange(irrbed, min_obj_distance, progressind, cfn);
+        arrange.rotations(rotations);
 
         // Arrange and return the items with their respective indices within the
         // input sequence.
@@ -29,8 +29,20 @@ enum class BedShapeType {
     WHO_KNOWS
 };
 
+enum class ArrangeMode {
+    NFP,        // No fit polygon placement, the densest piles.
+    SKYLINE     // Bottom-left skyline of the convex hulls' bounding boxes,
+                // fast enough for hundreds of instances. Only for box shaped
+                // and circular beds, the others fall back to NFP.
+};
+
+/// The number of instances from which the nfp arrangement gets too slow to be
+/// interactive and the skyline mode is used instead.
+const unsigned SKYLINE_INSTANCE_THRESHOLD = 500;
+
 struct BedShapeHint {
     BedShapeType type;
+    ArrangeMode mode = ArrangeMode::NFP;
     /*union*/ struct {  // I know but who cares...
         Circle circ;
         BoundingBox box;
@@ -72,6 +84,9 @@ struct WipeTowerInfo {
  * \param progressind Progress indicator callback called when an object gets
  * packed. The unsigned argument is the number of items remaining to pack.
  * \param stopcondition A predicate returning true if abort is needed.
+ * \param rotations The number of candidate rotations around the Z axis tried
+ * for each item, evenly spaced over the full circle. The default of one keeps
+ * the items in their current orientation.
  */
 bool arrange(Model &model,
              WipeTowerInfo& wipe_tower_info,
@@ -80,7 +95,8 @@ bool arrange(Model &model,
              BedShapeHint bedhint,
              bool first_bin_only,
              std::function<void(unsigned)> progressind,
-             std::function<bool(void)> stopcondition);
+             std::function<bool(void)> stopcondition,
+             unsigned rotations = 1);
 
 /// This will find a suitable position for a new object instance and leave the
 /// old items untouched.
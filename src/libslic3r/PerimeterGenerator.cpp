@@ -3,9 +3,76 @@
 #include "ExtrusionEntityCollection.hpp"
 #include <cmath>
 #include <cassert>
+#include <chrono>
 
 namespace Slic3r {
 
+void MedialAxisCache::medial_axis(const ExPolygon &expolygon, double max_width, double min_width, ThickPolylines *polylines)
+{
+    ++ m_lookups;
+    size_t hash = hash_expolygon(expolygon, max_width, min_width);
+    {
+        tbb::spin_mutex::scoped_lock lock(m_mutex);
+        auto range = m_entries.equal_range(hash);
+        for (auto it = range.first; it != range.second; ++ it)
+            if (it->second.matches(expolygon, max_width, min_width)) {
+                polylines->insert(polylines->end(), it->second.polylines.begin(), it->second.polylines.end());
+                ++ m_hits;
+                return;
+            }
+    }
+
+    // Calculate the medial axis outside of the lock.
+    Entry entry;
+    auto  t_start = std::chrono::steady_clock::now();
+    expolygon.medial_axis(max_width, min_width, &entry.polylines);
+    m_compute_time_ns += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - t_start).count();
+    polylines->insert(polylines->end(), entry.polylines.begin(), entry.polylines.end());
+
+    // Both the key and the result are stored, count the points of both.
+    size_t num_points = expolygon.contour.points.size();
+    for (const Polygon &hole : expolygon.holes)
+        num_points += hole.points.size();
+    for (const ThickPolyline &polyline : entry.polylines)
+        num_points += polyline.points.size();
+    entry.expolygon = expolygon;
+    entry.max_width = max_width;
+    entry.min_width = min_width;
+
+    tbb::spin_mutex::scoped_lock lock(m_mutex);
+    if (m_num_points + num_points > s_max_points) {
+        m_entries.clear();
+        m_num_points = 0;
+    }
+    m_entries.insert(std::make_pair(hash, std::move(entry)));
+    m_num_points += num_points;
+}
+
+bool MedialAxisCache::Entry::matches(const ExPolygon &rhs, double rhs_max_width, double rhs_min_width) const
+{
+    if (max_width != rhs_max_width || min_width != rhs_min_width ||
+        expolygon.contour.points != rhs.contour.points || expolygon.holes.size() != rhs.holes.size())
+        return false;
+    for (size_t i = 0; i < expolygon.holes.size(); ++ i)
+        if (expolygon.holes[i].points != rhs.holes[i].points)
+            return false;
+    return true;
+}
+
+size_t MedialAxisCache::hash_expolygon(const ExPolygon &expolygon, double max_width, double min_width)
+{
+    size_t seed = std::hash<double>()(max_width) ^ (std::hash<double>()(min_width) << 1);
+    auto   hash_points = [&seed](const Points &pts) {
+        for (const Point &pt : pts)
+            seed ^= PointHash()(pt) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+        seed ^= pts.size() + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+    };
+    hash_points(expolygon.contour.points);
+    for (const Polygon &hole : expolygon.holes)
+        hash_points(hole.points);
+    return seed;
+}
+
 void PerimeterGenerator::process()
 {
     // other perimeters
@@ -85,7 +152,7 @@ void PerimeterGenerator::process()
                             - min_width / 2, min_width / 2);
                         // the maximum thickness of our thin wall area is equal to the minimum thickness of a single loop
                         for (ExPolygon &ex : expp)
-                            ex.medial_axis(ext_perimeter_width + ext_perimeter_spacing2, min_width, &thin_walls);
+                            this->medial_axis(ex, ext_perimeter_width + ext_perimeter_spacing2, min_width, &thin_walls);
                     }
                 } else {
                     //FIXME Is this offset correct if the line width of the inner perimeters differs
@@ -213,7 +280,7 @@ void PerimeterGenerator::process()
                 true);
             ThickPolylines polylines;
             for (const ExPolygon &ex : gaps_ex)
-                ex.medial_axis(max, min, &polylines);
+                this->medial_axis(ex, max, min, &polylines);
             if (! polylines.empty()) {
                 ExtrusionEntityCollection gap_fill = this->_variable_width(polylines, 
                     erGapFill, this->solid_infill_flow);
@@ -446,6 +513,14 @@ static inline ExtrusionPaths thick_polyline_to_extrusion_paths(const ThickPolyli
     return paths;
 }
 
+void PerimeterGenerator::medial_axis(const ExPolygon &expolygon, double max_width, double min_width, ThickPolylines *polylines) const
+{
+    if (this->medial_axis_cache == nullptr)
+        expolygon.medial_axis(max_width, min_width, polylines);
+    else
+        this->medial_axis_cache->medial_axis(expolygon, max_width, min_width, polylines);
+}
+
 ExtrusionEntityCollection PerimeterGenerator::_variable_width(const ThickPolylines &polylines, ExtrusionRole role, Flow flow) const
 {
     // This value determines granularity of adaptive width, as G-code does not allow
@@ -2,7 +2,10 @@
 #define slic3r_PerimeterGenerator_hpp_
 
 #include "libslic3r.h"
+#include <atomic>
+#include <unordered_map>
 #include <vector>
+#include <tbb/spin_mutex.h>
 #include "ExPolygonCollection.hpp"
 #include "Flow.hpp"
 #include "Polygon.hpp"
@@ -34,6 +37,46 @@ public:
 
 typedef std::vector<PerimeterGeneratorLoop> PerimeterGeneratorLoops;
 
+// Cache of the medial axis results, shared by the layers and the threads generating perimeters of a PrintObject.
+// Prismatic parts produce the very same thin walls and gaps on many layers, and the Voronoi diagram
+// calculated by the medial axis is expensive. The cache is keyed by the exact coordinates of the ExPolygon
+// and by the width limits, therefore a hit returns exactly what ExPolygon::medial_axis() would return.
+// It lives for the duration of PrintObject::make_perimeters() only.
+class MedialAxisCache
+{
+public:
+    void    medial_axis(const ExPolygon &expolygon, double max_width, double min_width, ThickPolylines *polylines);
+
+    // Statistics, updated atomically by the perimeter worker threads.
+    size_t  lookups()          const { return m_lookups; }
+    size_t  hits()             const { return m_hits; }
+    // Time spent calculating the medial axes of the cache misses, in seconds.
+    double  compute_time()     const { return double(m_compute_time_ns) * 1e-9; }
+
+private:
+    struct Entry
+    {
+        ExPolygon       expolygon;
+        double          max_width;
+        double          min_width;
+        ThickPolylines  polylines;
+
+        bool matches(const ExPolygon &rhs, double rhs_max_width, double rhs_min_width) const;
+    };
+
+    static size_t hash_expolygon(const ExPolygon &expolygon, double max_width, double min_width);
+
+    // Once the cached ExPolygons and their medial axes grow over this number of points, the cache is flushed.
+    static const size_t                     s_max_points = 4 * 1024 * 1024;
+    std::unordered_multimap<size_t, Entry>  m_entries;
+    size_t                                  m_num_points = 0;
+    tbb::spin_mutex                         m_mutex;
+
+    std::atomic<size_t>                     m_lookups { 0 };
+    std::atomic<size_t>                     m_hits { 0 };
+    std::atomic<int64_t>                    m_compute_time_ns { 0 };
+};
+
 class PerimeterGenerator {
 public:
     // Inputs:
@@ -48,6 +91,8 @@ public:
     const PrintRegionConfig     *config;
     const PrintObjectConfig     *object_config;
     const PrintConfig           *print_config;
+    // Optional cache of the medial axes of thin walls and gaps.
+    MedialAxisCache             *medial_axis_cache;
     // Outputs:
     ExtrusionEntityCollection   *loops;
     ExtrusionEntityCollection   *gap_fill;
@@ -72,7 +117,7 @@ public:
             layer_id(-1), perimeter_flow(flow), ext_perimeter_flow(flow),
             overhang_flow(flow), solid_infill_flow(flow),
             config(config), object_config(object_config), print_config(print_config),
-            loops(loops), gap_fill(gap_fill), fill_surfaces(fill_surfaces),
+            medial_axis_cache(nullptr), loops(loops), gap_fill(gap_fill), fill_surfaces(fill_surfaces),
             _ext_mm3_per_mm(-1), _mm3_per_mm(-1), _mm3_per_mm_overhang(-1)
         {};
     void process();
@@ -83,6 +128,7 @@ private:
     double      _mm3_per_mm_overhang;
     Polygons    _lower_slices_p;
     
+    void medial_axis(const ExPolygon &expolygon, double max_width, double min_width, ThickPolylines *polylines) const;
     ExtrusionEntityCollection _traverse_loops(const PerimeterGeneratorLoops &loops, ThickPolylines &thin_walls) const;
     ExtrusionEntityCollection _variable_width(const ThickPolylines &polylines, ExtrusionRole role, Flow flow) const;
 };
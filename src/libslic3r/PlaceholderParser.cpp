@@ -51,6 +51,8 @@
 #include <iostream>
 #include <string>
 
+#include <tbb/spin_mutex.h>
+
 // #define USE_CPP11_REGEX
 #ifdef USE_CPP11_REGEX
     #include <regex>
@@ -1227,6 +1229,235 @@ namespace client
     };
 }
 
+namespace client
+{
+    // A template split into a free-form text and variable references.
+    // Most of the custom G-code templates expanded on each layer or tool change contain just that,
+    // therefore they are expanded by CompiledTemplate without running the macro grammar.
+    struct CompiledTemplate
+    {
+        enum SegmentType {
+            // Free-form text, copied to the output.
+            SEGMENT_TEXT,
+            // [variable] or [vector_variable_index]
+            SEGMENT_LEGACY_VARIABLE,
+            // [vector_variable[index_variable]]
+            SEGMENT_LEGACY_VECTOR_VARIABLE,
+            // {variable}
+            SEGMENT_VARIABLE,
+            // {vector_variable[index]}
+            SEGMENT_VECTOR_VARIABLE,
+        };
+
+        struct Segment {
+            SegmentType type;
+            // Text of SEGMENT_TEXT, variable name otherwise.
+            std::string text;
+            // Name of the indexing variable of SEGMENT_LEGACY_VECTOR_VARIABLE.
+            std::string index_name;
+            // Index of SEGMENT_VECTOR_VARIABLE.
+            int         index = 0;
+        };
+
+        // False if the template uses the macro language beyond the variable references.
+        // Such a template is processed by the macro grammar.
+        bool                    simple = true;
+        std::vector<Segment>    segments;
+
+        // Expand the template. Throws qi::expectation_failure on an error, in that case the template shall be processed
+        // by the macro grammar to produce the error message.
+        std::string evaluate(const MyContext &context) const
+        {
+            typedef std::string::const_iterator Iterator;
+            std::string output;
+            for (const Segment &segment : this->segments) {
+                boost::iterator_range<Iterator> name(segment.text.begin(), segment.text.end());
+                switch (segment.type) {
+                case SEGMENT_TEXT:
+                    output += segment.text;
+                    break;
+                case SEGMENT_LEGACY_VARIABLE:
+                {
+                    std::string value;
+                    MyContext::legacy_variable_expansion(&context, name, value);
+                    output += value;
+                    break;
+                }
+                case SEGMENT_LEGACY_VECTOR_VARIABLE:
+                {
+                    boost::iterator_range<Iterator> index_name(segment.index_name.begin(), segment.index_name.end());
+                    std::string value;
+                    MyContext::legacy_variable_expansion2(&context, name, index_name, value);
+                    output += value;
+                    break;
+                }
+                case SEGMENT_VARIABLE:
+                case SEGMENT_VECTOR_VARIABLE:
+                {
+                    OptWithPos<Iterator> opt;
+                    expr<Iterator>       value;
+                    MyContext::resolve_variable(&context, name, opt);
+                    if (segment.type == SEGMENT_VARIABLE)
+                        MyContext::scalar_variable_reference(&context, opt, value);
+                    else {
+                        int index = segment.index;
+                        MyContext::vector_variable_reference(&context, opt, index, name.end(), value);
+                    }
+                    output += value.to_string();
+                    break;
+                }
+                }
+            }
+            return output;
+        }
+    };
+}
+
+// White space as skipped by the spirit::ascii::space skipper of the macro grammar.
+static inline bool is_template_space(char c)
+{
+    return c == ' ' || c == '\t' || c == '\n' || c == '\v' || c == '\f' || c == '\r';
+}
+
+static inline void skip_template_space(const char *&it, const char *end)
+{
+    while (it != end && is_template_space(*it))
+        ++ it;
+}
+
+// Parse an identifier as the "identifier" rule of the macro grammar does, skipping the leading white space.
+static bool parse_template_identifier(const char *&it, const char *end, std::string &out)
+{
+    static const char *keywords[] = { "and", "if", "else", "elsif", "endif", "false", "min", "max", "not", "or", "true" };
+    auto is_alpha = [](char c) { return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_'; };
+    skip_template_space(it, end);
+    if (it == end || ! is_alpha(*it))
+        return false;
+    const char *begin = it;
+    for (++ it; it != end && (is_alpha(*it) || (*it >= '0' && *it <= '9')); ++ it) ;
+    out.assign(begin, it);
+    for (const char *keyword : keywords)
+        if (out == keyword)
+            return false;
+    return true;
+}
+
+// Parse a non-negative integer, skipping the leading white space.
+static bool parse_template_index(const char *&it, const char *end, int &out)
+{
+    skip_template_space(it, end);
+    const char *begin = it;
+    for (out = 0; it != end && *it >= '0' && *it <= '9' && it - begin < 9; ++ it)
+        out = out * 10 + (*it - '0');
+    return it != begin && (it == end || *it < '0' || *it > '9');
+}
+
+static bool parse_template_char(const char *&it, const char *end, char c)
+{
+    skip_template_space(it, end);
+    if (it == end || *it != c)
+        return false;
+    ++ it;
+    return true;
+}
+
+// Split the template into a free-form text and variable references.
+// If anything else is found, the template is marked as not simple to be processed by the macro grammar.
+static client::CompiledTemplate compile_template(const std::string &templ)
+{
+    typedef client::CompiledTemplate CompiledTemplate;
+    CompiledTemplate out;
+    const char *it  = templ.data();
+    const char *end = it + templ.size();
+    auto add_segment = [&out](CompiledTemplate::SegmentType type, std::string &&text) -> CompiledTemplate::Segment& {
+        out.segments.emplace_back();
+        out.segments.back().type = type;
+        out.segments.back().text = std::move(text);
+        return out.segments.back();
+    };
+    // The start rule of the macro grammar skips the leading white space.
+    skip_template_space(it, end);
+    while (it != end) {
+        const char *text_begin = it;
+        for (; it != end && *it != '[' && *it != '{'; ++ it)
+            if ((unsigned char)*it >= 0x80) {
+                // Let the macro grammar validate the UTF-8 sequences.
+                out.simple = false;
+                return out;
+            }
+        if (it != text_begin)
+            add_segment(CompiledTemplate::SEGMENT_TEXT, std::string(text_begin, it));
+        if (it == end)
+            break;
+        const char  *p = it + 1;
+        std::string  name;
+        std::string  index_name;
+        int          index = 0;
+        if (! parse_template_identifier(p, end, name)) {
+            out.simple = false;
+            return out;
+        }
+        const char *p_name_end = p;
+        if (*it == '[') {
+            if (parse_template_char(p, end, ']')) {
+                add_segment(CompiledTemplate::SEGMENT_LEGACY_VARIABLE, std::move(name));
+                it = p;
+                continue;
+            }
+            p = p_name_end;
+            if (parse_template_char(p, end, '[') && parse_template_identifier(p, end, index_name) && 
+                parse_template_char(p, end, ']') && parse_template_char(p, end, ']')) {
+                add_segment(CompiledTemplate::SEGMENT_LEGACY_VECTOR_VARIABLE, std::move(name)).index_name = std::move(index_name);
+                it = p;
+                continue;
+            }
+        } else {
+            if (parse_template_char(p, end, '}')) {
+                add_segment(CompiledTemplate::SEGMENT_VARIABLE, std::move(name));
+                it = p;
+                continue;
+            }
+            p = p_name_end;
+            if (parse_template_char(p, end, '[') && parse_template_index(p, end, index) && 
+                parse_template_char(p, end, ']') && parse_template_char(p, end, '}')) {
+                add_segment(CompiledTemplate::SEGMENT_VECTOR_VARIABLE, std::move(name)).index = index;
+                it = p;
+                continue;
+            }
+        }
+        out.simple = false;
+        return out;
+    }
+    return out;
+}
+
+// Compile the template or return the cached compiled template.
+// The same templates are processed over and over (on each layer change, tool change, object start).
+static std::shared_ptr<const client::CompiledTemplate> compiled_template(const std::string &templ)
+{
+    // Long templates are not cached, they are likely generated (the wipe tower G-code) and not repeated.
+    static const size_t max_cached_template_length = 65536;
+    // Once the cache grows over this number of templates, it is flushed.
+    static const size_t max_cached_templates = 256;
+    static std::map<std::string, std::shared_ptr<const client::CompiledTemplate>> cache;
+    static tbb::spin_mutex mutex;
+
+    if (templ.size() > max_cached_template_length)
+        return std::make_shared<const client::CompiledTemplate>(compile_template(templ));
+    {
+        tbb::spin_mutex::scoped_lock lock(mutex);
+        auto it = cache.find(templ);
+        if (it != cache.end())
+            return it->second;
+    }
+    // Compile outside of the lock.
+    auto compiled = std::make_shared<const client::CompiledTemplate>(compile_template(templ));
+    tbb::spin_mutex::scoped_lock lock(mutex);
+    if (cache.size() >= max_cached_templates)
+        cache.clear();
+    return cache.insert(std::make_pair(templ, std::move(compiled))).first->second;
+}
+
 static std::string process_macro(const std::string &templ, client::MyContext &context)
 {
     typedef std::string::const_iterator iterator_type;
@@ -1258,6 +1489,14 @@ std::string PlaceholderParser::process(const std::string &templ, unsigned int cu
     context.config              = &this->config();
     context.config_override     = config_override;
     context.current_extruder_id = current_extruder_id;
+    std::shared_ptr<const client::CompiledTemplate> compiled = compiled_template(templ);
+    if (compiled->simple) {
+        try {
+            return compiled->evaluate(context);
+        } catch (qi::expectation_failure<std::string::const_iterator> &) {
+            // Let the macro grammar produce the error message.
+        }
+    }
     return process_macro(templ, context);
 }
 
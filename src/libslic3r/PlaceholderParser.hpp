@@ -37,6 +37,7 @@ public:
     const ConfigOption*     option(const std::string &key) const { return m_config.option(key); }
 
     // Fill in the template using a macro processing language.
+    // Templates containing just a text and variable references are compiled once and cached, avoiding the macro grammar.
     // Throws std::runtime_error on syntax or runtime error.
     std::string process(const std::string &templ, unsigned int current_extruder_id, const DynamicConfig *config_override = nullptr) const;
     
@@ -20,6 +20,8 @@
 #include "libslic3r.h"
 #include "Config.hpp"
 
+#include <unordered_map>
+
 // #define HAS_PRESSURE_EQUALIZER
 
 namespace Slic3r {
@@ -264,7 +266,8 @@ protected:
         }
 
     protected:
-        std::map<std::string, ptrdiff_t>    m_map_name_to_offset;
+        // Hashed, as the options of the static configs are looked up by name over and over by Print::apply().
+        std::unordered_map<std::string, ptrdiff_t>  m_map_name_to_offset;
     };
 
     // Parametrized by the type of the topmost class owning the options.
@@ -293,6 +296,29 @@ protected:
         const std::vector<std::string>& keys()      const { return m_keys; }
         const T&                        defaults()  const { return *m_defaults; }
 
+        // Collect keys of the options differing between owner and other.
+        // The options of the owner are accessed through the offsets, they are not looked up by name.
+        t_config_option_keys diff(const T *owner, const ConfigBase &other) const
+        {
+            t_config_option_keys out;
+            for (size_t i = 0; i < m_keys.size(); ++ i) {
+                const ConfigOption *other_opt = other.option(m_keys[i]);
+                if (other_opt != nullptr && *this->optptr_at(i, owner) != *other_opt)
+                    out.emplace_back(m_keys[i]);
+            }
+            return out;
+        }
+
+        // Collect keys of the options differing between owner and other of the same type.
+        t_config_option_keys diff(const T *owner, const T *other) const
+        {
+            t_config_option_keys out;
+            for (size_t i = 0; i < m_keys.size(); ++ i)
+                if (*this->optptr_at(i, owner) != *this->optptr_at(i, other))
+                    out.emplace_back(m_keys[i]);
+            return out;
+        }
+
         // To be called during the StaticCache setup.
         // Collect option keys from m_map_name_to_offset,
         // assign default values to m_defaults.
@@ -302,6 +328,8 @@ protected:
             m_defaults = defaults;
             m_keys.clear();
             m_keys.reserve(m_map_name_to_offset.size());
+            m_offsets.clear();
+            m_offsets.reserve(m_map_name_to_offset.size());
             for (const auto &kvp : defs->options) {
                 // Find the option given the option name kvp.first by an offset from (char*)m_defaults.
                 ConfigOption *opt = this->optptr(kvp.first, m_defaults);
@@ -309,6 +337,7 @@ protected:
                     // This option is not defined by the ConfigBase of type T.
                     continue;
                 m_keys.emplace_back(kvp.first);
+                m_offsets.emplace_back((const char*)opt - (const char*)m_defaults);
                 const ConfigOptionDef *def = defs->get(kvp.first);
                 assert(def != nullptr);
                 if (def->default_value)
@@ -317,8 +346,13 @@ protected:
         }
 
     private:
+        const ConfigOption* optptr_at(size_t idx, const T *owner) const
+            { return reinterpret_cast<const ConfigOption*>((const char*)owner + m_offsets[idx]); }
+
         T                                  *m_defaults;
         std::vector<std::string>            m_keys;
+        // Offsets of the options in the order of m_keys.
+        std::vector<ptrdiff_t>              m_offsets;
     };
 };
 
@@ -329,6 +363,9 @@ public: \
         { return s_cache_##CLASS_NAME.optptr(opt_key, this); } \
     /* Overrides ConfigBase::keys(). Collect names of all configuration values maintained by this configuration store. */ \
     t_config_option_keys     keys() const override { return s_cache_##CLASS_NAME.keys(); } \
+    /* Hides ConfigBase::diff(). Collect keys of the options differing from other, without looking up the options of this by name. */ \
+    t_config_option_keys     diff(const ConfigBase &other) const { return s_cache_##CLASS_NAME.diff(this, other); } \
+    t_config_option_keys     diff(const CLASS_NAME &other) const { return s_cache_##CLASS_NAME.diff(this, &other); } \
     static const CLASS_NAME& defaults() { initialize_cache(); return s_cache_##CLASS_NAME.defaults(); } \
 private: \
     static void initialize_cache() \
@@ -3,6 +3,7 @@
 #include "ClipperUtils.hpp"
 #include "Geometry.hpp"
 #include "I18N.hpp"
+#include "PerimeterGenerator.hpp"
 #include "SupportMaterial.hpp"
 #include "Surface.hpp"
 #include "Slicing.hpp"
@@ -40,6 +41,88 @@
 
 namespace Slic3r {
 
+static inline void hash_combine(size_t &seed, size_t value)
+{
+    seed ^= value + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+}
+
+static void hash_expolygon(size_t &seed, const ExPolygon &expolygon)
+{
+    for (const Point &pt : expolygon.contour.points)
+        hash_combine(seed, PointHash()(pt));
+    for (const Polygon &hole : expolygon.holes) {
+        hash_combine(seed, hole.points.size());
+        for (const Point &pt : hole.points)
+            hash_combine(seed, PointHash()(pt));
+    }
+}
+
+// Hash of everything a layer feeds to the perimeter generator, to quickly reject layers which cannot produce
+// the same perimeters. The neighbor dependency (overhangs) is taken into account by layer_perimeters_identical().
+static size_t layer_perimeters_hash(const Layer &layer)
+{
+    size_t seed = std::hash<double>()(layer.height);
+    for (const LayerRegion *layerm : layer.regions()) {
+        hash_combine(seed, std::hash<const void*>()(layerm->region()));
+        for (const Surface &surface : layerm->slices.surfaces) {
+            hash_combine(seed, size_t(surface.surface_type) | (size_t(surface.extra_perimeters) << 8));
+            hash_expolygon(seed, surface.expolygon);
+        }
+    }
+    return seed;
+}
+
+static bool surfaces_identical(const Surfaces &lhs, const Surfaces &rhs)
+{
+    if (lhs.size() != rhs.size())
+        return false;
+    for (size_t i = 0; i < lhs.size(); ++ i) {
+        const Surface &l = lhs[i];
+        const Surface &r = rhs[i];
+        if (l.surface_type != r.surface_type || l.extra_perimeters != r.extra_perimeters ||
+            l.thickness != r.thickness || l.thickness_layers != r.thickness_layers || l.bridge_angle != r.bridge_angle ||
+            l.expolygon.contour.points != r.expolygon.contour.points || l.expolygon.holes.size() != r.expolygon.holes.size())
+            return false;
+        for (size_t j = 0; j < l.expolygon.holes.size(); ++ j)
+            if (l.expolygon.holes[j].points != r.expolygon.holes[j].points)
+                return false;
+    }
+    return true;
+}
+
+static bool expolygons_identical(const ExPolygons &lhs, const ExPolygons &rhs)
+{
+    if (lhs.size() != rhs.size())
+        return false;
+    for (size_t i = 0; i < lhs.size(); ++ i) {
+        if (lhs[i].contour.points != rhs[i].contour.points || lhs[i].holes.size() != rhs[i].holes.size())
+            return false;
+        for (size_t j = 0; j < lhs[i].holes.size(); ++ j)
+            if (lhs[i].holes[j].points != rhs[i].holes[j].points)
+                return false;
+    }
+    return true;
+}
+
+// Will the perimeter generator produce the same perimeters, gap fills and fill surfaces for the layer
+// as for the other layer? The region slices and the layer height have to match, and because the overhangs
+// are detected against the layer below, the layers below the two layers have to match as well.
+// The first layer is never shared, it is printed with the first layer flow.
+static bool layer_perimeters_identical(const Layer &layer, const Layer &other)
+{
+    if (layer.id() == 0 || other.id() == 0 || layer.height != other.height || layer.region_count() != other.region_count() ||
+        layer.lower_layer == nullptr || other.lower_layer == nullptr ||
+        ! expolygons_identical(layer.lower_layer->slices.expolygons, other.lower_layer->slices.expolygons))
+        return false;
+    for (size_t region_id = 0; region_id < layer.region_count(); ++ region_id) {
+        const LayerRegion &layerm = *layer.regions()[region_id];
+        const LayerRegion &other_layerm = *other.regions()[region_id];
+        if (layerm.region() != other_layerm.region() || ! surfaces_identical(layerm.slices.surfaces, other_layerm.slices.surfaces))
+            return false;
+    }
+    return true;
+}
+
 PrintObject::PrintObject(Print* print, ModelObject* model_object, bool add_instances) :
     PrintObjectBaseWithState(print, model_object),
     typed_slices(false),
@@ -220,18 +303,68 @@ void PrintObject::make_perimeters()
         BOOST_LOG_TRIVIAL(debug) << "Generating extra perimeters for region " << region_id << " in parallel - end";
     }
 
+    // Detect runs of layers producing the same perimeters (typical for extruded profiles),
+    // so that the perimeters are generated just once for the first layer of the run and copied to the others.
+    // layer_source[i] is the index of the layer the perimeters of the i-th layer are taken from.
+    std::vector<size_t> layer_source(m_layers.size(), 0);
+    {
+        std::vector<size_t> layer_hash(m_layers.size(), 0);
+        tbb::parallel_for(
+            tbb::blocked_range<size_t>(0, m_layers.size()),
+            [this, &layer_hash](const tbb::blocked_range<size_t>& range) {
+                for (size_t layer_idx = range.begin(); layer_idx < range.end(); ++ layer_idx)
+                    layer_hash[layer_idx] = layer_perimeters_hash(*m_layers[layer_idx]);
+            }
+        );
+        for (size_t layer_idx = 0; layer_idx < m_layers.size(); ++ layer_idx)
+            layer_source[layer_idx] = (layer_idx > 0 && layer_hash[layer_idx] == layer_hash[layer_idx - 1] &&
+                layer_perimeters_identical(*m_layers[layer_idx], *m_layers[layer_idx - 1])) ?
+                layer_source[layer_idx - 1] : layer_idx;
+    }
+
     BOOST_LOG_TRIVIAL(debug) << "Generating perimeters in parallel - start";
+    {
+        // Thin walls and gaps repeat over the layers of prismatic parts, share their medial axes
+        // between the layers of this object. The cache is released once the perimeters are generated.
+        MedialAxisCache medial_axis_cache;
+        tbb::parallel_for(
+            tbb::blocked_range<size_t>(0, m_layers.size()),
+            [this, &layer_source, &medial_axis_cache](const tbb::blocked_range<size_t>& range) {
+                for (size_t layer_idx = range.begin(); layer_idx < range.end(); ++ layer_idx)
+                    if (layer_source[layer_idx] == layer_idx) {
+                        m_print->throw_if_canceled();
+                        m_layers[layer_idx]->make_perimeters(&medial_axis_cache);
+                    }
+            }
+        );
+        m_print->throw_if_canceled();
+        BOOST_LOG_TRIVIAL(debug) << "Medial axis cache: " << medial_axis_cache.hits() << " hits of " << medial_axis_cache.lookups() <<
+            " lookups, " << medial_axis_cache.compute_time() * 1000. << " ms spent in the medial axis calculation";
+    }
+    BOOST_LOG_TRIVIAL(debug) << "Generating perimeters in parallel - end";
+
+    BOOST_LOG_TRIVIAL(debug) << "Sharing perimeters of identical layers in parallel - start";
     tbb::parallel_for(
         tbb::blocked_range<size_t>(0, m_layers.size()),
-        [this](const tbb::blocked_range<size_t>& range) {
-            for (size_t layer_idx = range.begin(); layer_idx < range.end(); ++ layer_idx) {
-                m_print->throw_if_canceled();
-                m_layers[layer_idx]->make_perimeters();
-            }
+        [this, &layer_source](const tbb::blocked_range<size_t>& range) {
+            for (size_t layer_idx = range.begin(); layer_idx < range.end(); ++ layer_idx)
+                if (layer_source[layer_idx] != layer_idx) {
+                    m_print->throw_if_canceled();
+                    const Layer &src = *m_layers[layer_source[layer_idx]];
+                    Layer       &dst = *m_layers[layer_idx];
+                    for (size_t region_id = 0; region_id < dst.region_count(); ++ region_id) {
+                        const LayerRegion &src_layerm = *src.regions()[region_id];
+                        LayerRegion       &dst_layerm = *dst.get_region(int(region_id));
+                        dst_layerm.perimeters      = src_layerm.perimeters;
+                        dst_layerm.thin_fills      = src_layerm.thin_fills;
+                        dst_layerm.fill_surfaces   = src_layerm.fill_surfaces;
+                        dst_layerm.fill_expolygons = src_layerm.fill_expolygons;
+                    }
+                }
         }
     );
     m_print->throw_if_canceled();
-    BOOST_LOG_TRIVIAL(debug) << "Generating perimeters in parallel - end";
+    BOOST_LOG_TRIVIAL(debug) << "Sharing perimeters of identical layers in parallel - end";
 
     /*
         simplify slices (both layer and region slices),
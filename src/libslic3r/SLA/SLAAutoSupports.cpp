@@ -12,6 +12,7 @@
 #include "Tesselate.hpp"
 #include "libslic3r.h"
 
+#include <algorithm>
 #include <iostream>
 #include <random>
 
@@ -91,6 +92,84 @@ void SLAAutoSupports::project_onto_mesh(std::vector<sla::SupportPoint>& points)
         });
 }
 
+// Bounding boxes of the islands of a layer indexed by a uniform grid, to find the islands of a layer, which may overlap
+// an island of the neighbor layer, without testing all pairs of islands. The cell size is chosen for about a single
+// island per cell, which works well for the many tiny islands of lattices and porous parts.
+class IslandBBoxGrid {
+public:
+    IslandBBoxGrid(const std::vector<SLAAutoSupports::Structure> &islands)
+    {
+        if (islands.empty())
+            return;
+        m_bbox = islands.front().bbox;
+        for (const SLAAutoSupports::Structure &island : islands)
+            m_bbox.merge(island.bbox);
+        const double size_x = double(m_bbox.max.x() - m_bbox.min.x()) + 1.;
+        const double size_y = double(m_bbox.max.y() - m_bbox.min.y()) + 1.;
+        // Limit the number of cells along each axis by the number of islands for elongated layers.
+        m_cell_size = coord_t(std::ceil(std::max(std::sqrt(size_x * size_y / double(islands.size())), std::max(size_x, size_y) / double(islands.size()))));
+        m_cells     = Vec2i(int(size_x / double(m_cell_size)) + 1, int(size_y / double(m_cell_size)) + 1);
+        // Two passes over the islands, the first one counts the islands of each cell, the second one fills them in.
+        m_cell_starts.assign(size_t(m_cells.x()) * size_t(m_cells.y()) + 1, 0);
+        for (int pass = 0; pass < 2; ++ pass) {
+            std::vector<size_t> cell_ends;
+            if (pass == 1) {
+                for (size_t i = 1; i < m_cell_starts.size(); ++ i)
+                    m_cell_starts[i] += m_cell_starts[i - 1];
+                m_island_indices.assign(m_cell_starts.back(), 0);
+                cell_ends.assign(m_cell_starts.begin(), m_cell_starts.end() - 1);
+            }
+            for (size_t island_idx = 0; island_idx < islands.size(); ++ island_idx) {
+                Vec2i cmin, cmax;
+                this->cell_range(islands[island_idx].bbox, cmin, cmax);
+                for (int j = cmin.y(); j <= cmax.y(); ++ j)
+                    for (int i = cmin.x(); i <= cmax.x(); ++ i) {
+                        size_t idx = size_t(j) * size_t(m_cells.x()) + size_t(i);
+                        if (pass == 0)
+                            ++ m_cell_starts[idx + 1];
+                        else
+                            m_island_indices[cell_ends[idx] ++] = island_idx;
+                    }
+            }
+        }
+    }
+
+    // Indices of the islands, which bounding boxes may overlap the bounding box, sorted in ascending order.
+    void query(const BoundingBox &bbox, std::vector<size_t> &out) const
+    {
+        out.clear();
+        if (m_island_indices.empty() || ! m_bbox.overlap(bbox))
+            return;
+        Vec2i cmin, cmax;
+        this->cell_range(bbox, cmin, cmax);
+        for (int j = cmin.y(); j <= cmax.y(); ++ j)
+            for (int i = cmin.x(); i <= cmax.x(); ++ i) {
+                size_t idx = size_t(j) * size_t(m_cells.x()) + size_t(i);
+                out.insert(out.end(), m_island_indices.begin() + m_cell_starts[idx], m_island_indices.begin() + m_cell_starts[idx + 1]);
+            }
+        // An island spanning multiple cells is reported once.
+        std::sort(out.begin(), out.end());
+        out.erase(std::unique(out.begin(), out.end()), out.end());
+    }
+
+private:
+    void cell_range(const BoundingBox &bbox, Vec2i &cmin, Vec2i &cmax) const
+    {
+        auto cell = [this](coord_t c, coord_t c0, int num_cells) {
+            return std::min(std::max(int((c - c0) / m_cell_size), 0), num_cells - 1);
+        };
+        cmin = Vec2i(cell(bbox.min.x(), m_bbox.min.x(), m_cells.x()), cell(bbox.min.y(), m_bbox.min.y(), m_cells.y()));
+        cmax = Vec2i(cell(bbox.max.x(), m_bbox.min.x(), m_cells.x()), cell(bbox.max.y(), m_bbox.min.y(), m_cells.y()));
+    }
+
+    BoundingBox         m_bbox;
+    coord_t             m_cell_size = 1;
+    Vec2i               m_cells     = Vec2i::Zero();
+    // Island indices sorted by the cells, the islands of a cell idx are stored at <m_cell_starts[idx], m_cell_starts[idx + 1]).
+    std::vector<size_t> m_island_indices;
+    std::vector<size_t> m_cell_starts;
+};
+
 static std::vector<SLAAutoSupports::MyLayer> make_layers(
     const std::vector<ExPolygons>& slices, const std::vector<float>& heights,
     std::function<void(void)> throw_on_cancel)
@@ -143,9 +222,13 @@ static std::vector<SLAAutoSupports::MyLayer> make_layers(
             const float between_layers_offset =  float(scale_(layer_height / std::tan(safe_angle)));
             const float slope_angle = 75.f * (float(M_PI)/180.f); // smaller number - less supports
             const float slope_offset = float(scale_(layer_height / std::tan(slope_angle)));
-			//FIXME This has a quadratic time complexity, it will be excessively slow for many tiny islands.
+            // Only the islands below with an overlapping bounding box are tested for the polygon overlap.
+            const IslandBBoxGrid grid_below(layer_below.islands);
+            std::vector<size_t>  candidates;
 			for (SLAAutoSupports::Structure &top : layer_above.islands) {
-				for (SLAAutoSupports::Structure &bottom : layer_below.islands) {
+                grid_below.query(top.bbox, candidates);
+				for (size_t bottom_idx : candidates) {
+                    SLAAutoSupports::Structure &bottom = layer_below.islands[bottom_idx];
                     float overlap_area = top.overlap_area(bottom);
                     if (overlap_area > 0) {
 						top.islands_below.emplace_back(&bottom, overlap_area);
@@ -231,22 +314,46 @@ void SLAAutoSupports::process(const std::vector<ExPolygons>& slices, const std::
             }
         }
         // Now iterate over all polygons and append new points if needed.
-        for (Structure &s : layer_top->islands) {
-            // Penalization resulting from large diff from the last layer:
-//            s.supports_force_inherited /= std::max(1.f, (layer_height / 0.3f) * e_area / s.area);
-            s.supports_force_inherited /= std::max(1.f, 0.17f * (s.overhangs_area) / s.area);
-
-            //float force_deficit = s.support_force_deficit(m_config.tear_pressure());
-            if (s.islands_below.empty()) { // completely new island - needs support no doubt
-                uniformly_cover({ *s.polygon }, s, point_grid, true);
-            } else if (! s.dangling_areas.empty()) {
-                // Let's see if there's anything that overlaps enough to need supports:
-                // What we now have in polygons needs support, regardless of what the forces are, so we can add them.
-                //FIXME is it an island point or not? Vojtech thinks it is.
-                uniformly_cover(s.dangling_areas, s, point_grid);
-            } else if (! s.overhangs_slopes.empty()) {
-                //FIXME add the support force deficit as a parameter, only cover until the defficiency is covered.
-                uniformly_cover(s.overhangs_slopes, s, point_grid);
+        // The islands of a layer are sampled in parallel against the support points of the layers below,
+        // the samples are then added in the order of the islands to keep the result deterministic.
+        struct IslandSamples {
+            std::vector<Vec2f>  samples;
+            float               min_spacing   = 0.f;
+            bool                is_new_island = false;
+        };
+        std::vector<IslandSamples> island_samples(layer_top->islands.size());
+        tbb::parallel_for(tbb::blocked_range<size_t>(0, layer_top->islands.size()),
+            [this, layer_top, &island_samples, &point_grid](const tbb::blocked_range<size_t> &range) {
+            for (size_t island_idx = range.begin(); island_idx < range.end(); ++ island_idx) {
+                Structure     &s   = layer_top->islands[island_idx];
+                IslandSamples &out = island_samples[island_idx];
+                // Penalization resulting from large diff from the last layer:
+//              s.supports_force_inherited /= std::max(1.f, (layer_height / 0.3f) * e_area / s.area);
+                s.supports_force_inherited /= std::max(1.f, 0.17f * (s.overhangs_area) / s.area);
+
+                //float force_deficit = s.support_force_deficit(m_config.tear_pressure());
+                if (s.islands_below.empty()) { // completely new island - needs support no doubt
+                    out.min_spacing   = uniformly_cover({ *s.polygon }, s, point_grid, out.samples);
+                    out.is_new_island = true;
+                } else if (! s.dangling_areas.empty()) {
+                    // Let's see if there's anything that overlaps enough to need supports:
+                    // What we now have in polygons needs support, regardless of what the forces are, so we can add them.
+                    //FIXME is it an island point or not? Vojtech thinks it is.
+                    out.min_spacing = uniformly_cover(s.dangling_areas, s, point_grid, out.samples);
+                } else if (! s.overhangs_slopes.empty()) {
+                    //FIXME add the support force deficit as a parameter, only cover until the defficiency is covered.
+                    out.min_spacing = uniformly_cover(s.overhangs_slopes, s, point_grid, out.samples);
+                }
+            }
+        });
+        // Only the samples of the islands following an island, which already received support points in this layer,
+        // may collide with the support points of this layer.
+        bool layer_has_points = false;
+        for (size_t island_idx = 0; island_idx < layer_top->islands.size(); ++ island_idx) {
+            const IslandSamples &samples = island_samples[island_idx];
+            if (! samples.samples.empty()) {
+                add_support_points(samples.samples, samples.min_spacing, layer_top->islands[island_idx], point_grid, samples.is_new_island, layer_has_points);
+                layer_has_points = true;
             }
         }
 
@@ -326,30 +433,82 @@ std::vector<Vec2f> sample_expolygon_with_boundary(const ExPolygons &expolys, flo
     return out;
 }
 
+// Points in a dense grid over a rectangle, for the queries of points closer than the cell size.
+// Points outside of the rectangle are stored into the boundary cells.
+class PointGrid2D {
+public:
+    PointGrid2D(std::vector<Vec3f> &&points, const Vec2f &corner_min, const Vec2f &corner_max, float cell_size) :
+        m_corner_min(corner_min), m_cell_size(cell_size)
+    {
+        m_cells = ((corner_max - corner_min) / cell_size).cast<int>() + Vec2i(1, 1);
+        // Counting sort of the points by their cells.
+        std::vector<size_t> cell_ids;
+        cell_ids.reserve(points.size());
+        m_cell_starts.assign(size_t(m_cells.x()) * size_t(m_cells.y()) + 1, 0);
+        for (const Vec3f &pt : points) {
+            cell_ids.emplace_back(this->cell_idx(this->cell_id(pt)));
+            ++ m_cell_starts[cell_ids.back() + 1];
+        }
+        for (size_t i = 1; i < m_cell_starts.size(); ++ i)
+            m_cell_starts[i] += m_cell_starts[i - 1];
+        m_points.assign(points.size(), Vec3f::Zero());
+        std::vector<size_t> cell_ends(m_cell_starts.begin(), m_cell_starts.end() - 1);
+        for (size_t i = 0; i < points.size(); ++ i)
+            m_points[cell_ends[cell_ids[i]] ++] = points[i];
+    }
+
+    bool empty() const { return m_points.empty(); }
+
+    // The radius must not be bigger than the cell size.
+    bool collides_with(const Vec3f &pos, float radius) const {
+        assert(radius <= m_cell_size);
+        const Vec2i cell = this->cell_id(pos);
+        const float radius_squared = radius * radius;
+        for (int j = std::max(0, cell.y() - 1); j <= std::min(m_cells.y() - 1, cell.y() + 1); ++ j)
+            for (int i = std::max(0, cell.x() - 1); i <= std::min(m_cells.x() - 1, cell.x() + 1); ++ i) {
+                size_t idx = this->cell_idx(Vec2i(i, j));
+                for (size_t k = m_cell_starts[idx]; k < m_cell_starts[idx + 1]; ++ k)
+                    if ((m_points[k] - pos).squaredNorm() < radius_squared)
+                        return true;
+            }
+        return false;
+    }
+
+private:
+    Vec2i cell_id(const Vec3f &pos) const {
+        Vec2i id = ((Vec2f(pos.x(), pos.y()) - m_corner_min) / m_cell_size).array().floor().cast<int>();
+        return Vec2i(std::min(std::max(id.x(), 0), m_cells.x() - 1), std::min(std::max(id.y(), 0), m_cells.y() - 1));
+    }
+    size_t cell_idx(const Vec2i &cell) const { return size_t(cell.y()) * size_t(m_cells.x()) + size_t(cell.x()); }
+
+    Vec2f               m_corner_min;
+    float               m_cell_size;
+    Vec2i               m_cells;
+    // Points sorted by their cells, the points of a cell idx are stored at <m_cell_starts[idx], m_cell_starts[idx + 1]).
+    std::vector<Vec3f>  m_points;
+    std::vector<size_t> m_cell_starts;
+};
+
+// Poisson disk sampling by dart throwing over the raw samples, accelerated by a background grid with the cell size
+// equal to the radius (Bridson). The grid is dense over the bounding box of the raw samples, which are produced
+// with a constant density, therefore the grid is not much bigger than the raw samples.
+// The cells are visited in a random order, visiting them row by row would bias the dart throwing along the rows.
 template<typename REFUSE_FUNCTION>
-static inline std::vector<Vec2f> poisson_disk_from_samples(const std::vector<Vec2f> &raw_samples, float radius, REFUSE_FUNCTION refuse_function)
+static inline std::vector<Vec2f> poisson_disk_from_samples(const std::vector<Vec2f> &raw_samples, float radius, std::mt19937 &rng, REFUSE_FUNCTION refuse_function)
 {
-    Vec2f corner_min(std::numeric_limits<float>::max(), std::numeric_limits<float>::max());
-    for (const Vec2f &pt : raw_samples) {
-        corner_min.x() = std::min(corner_min.x(), pt.x());
-        corner_min.y() = std::min(corner_min.y(), pt.y());
-    }
+    if (raw_samples.empty())
+        return std::vector<Vec2f>();
 
-    // Assign the raw samples to grid cells, sort the grid cells lexicographically.
-    struct RawSample {
-        Vec2f coord;
-        Vec2i cell_id;
-    };
-    std::vector<RawSample> raw_samples_sorted;
-    RawSample sample;
+    Vec2f corner_min(std::numeric_limits<float>::max(), std::numeric_limits<float>::max());
+    Vec2f corner_max(- std::numeric_limits<float>::max(), - std::numeric_limits<float>::max());
     for (const Vec2f &pt : raw_samples) {
-        sample.coord   = pt;
-        sample.cell_id = ((pt - corner_min) / radius).cast<int>();
-        raw_samples_sorted.emplace_back(sample);
+        corner_min = corner_min.cwiseMin(pt);
+        corner_max = corner_max.cwiseMax(pt);
     }
-    std::sort(raw_samples_sorted.begin(), raw_samples_sorted.end(), [](const RawSample &lhs, const RawSample &rhs) 
-        { return lhs.cell_id.x() < rhs.cell_id.x() || (lhs.cell_id.x() == rhs.cell_id.x() && lhs.cell_id.y() < rhs.cell_id.y()); });
+    const Vec2i  num_cells = ((corner_max - corner_min) / radius).cast<int>() + Vec2i(1, 1);
+    auto         cell_idx  = [&num_cells](const Vec2i &cell_id) { return size_t(cell_id.y()) * size_t(num_cells.x()) + size_t(cell_id.x()); };
 
+    // Sort the raw samples by their cells with a counting sort.
     struct PoissonDiskGridEntry {
         // Resulting output sample points for this cell:
         enum {
@@ -358,96 +517,94 @@ static inline std::vector<Vec2f> poisson_disk_from_samples(const std::vector<Vec
         Vec2f   poisson_samples[max_positions];
         int     num_poisson_samples = 0;
 
-        // Index into raw_samples:
-        int     first_sample_idx;
-        int     sample_cnt;
+        // Index into raw_samples_sorted:
+        size_t  first_sample_idx = 0;
+        size_t  sample_cnt       = 0;
     };
-
-    struct CellIDHash {
-        std::size_t operator()(const Vec2i &cell_id) const {
-            return std::hash<int>()(cell_id.x()) ^ std::hash<int>()(cell_id.y() * 593);
-        }
-    };
-
-    // Map from cell IDs to hash_data.  Each hash_data points to the range in raw_samples corresponding to that cell.
-    // (We could just store the samples in hash_data.  This implementation is an artifact of the reference paper, which
-    // is optimizing for GPU acceleration that we haven't implemented currently.)
-    typedef std::unordered_map<Vec2i, PoissonDiskGridEntry, CellIDHash> Cells;
-    Cells cells;
+    std::vector<PoissonDiskGridEntry> cells(size_t(num_cells.x()) * size_t(num_cells.y()));
+    std::vector<size_t>               raw_sample_cells;
+    raw_sample_cells.reserve(raw_samples.size());
+    for (const Vec2f &pt : raw_samples) {
+        Vec2i cell_id = ((pt - corner_min) / radius).cast<int>();
+        raw_sample_cells.emplace_back(cell_idx(cell_id.cwiseMin(num_cells - Vec2i(1, 1))));
+        ++ cells[raw_sample_cells.back()].sample_cnt;
+    }
+    // Indices of the non-empty cells, in the order of the cells until shuffled below.
+    std::vector<size_t> active_cells;
     {
-        typename Cells::iterator last_cell_id_it;
-        Vec2i           last_cell_id(-1, -1);
-        for (size_t i = 0; i < raw_samples_sorted.size(); ++ i) {
-            const RawSample &sample = raw_samples_sorted[i];
-            if (sample.cell_id == last_cell_id) {
-                // This sample is in the same cell as the previous, so just increase the count.  Cells are
-                // always contiguous, since we've sorted raw_samples_sorted by cell ID.
-                ++ last_cell_id_it->second.sample_cnt;
-            } else {
-                // This is a new cell.
-                PoissonDiskGridEntry data;
-                data.first_sample_idx = i;
-                data.sample_cnt       = 1;
-                auto result     = cells.insert({sample.cell_id, data});
-                last_cell_id    = sample.cell_id;
-                last_cell_id_it = result.first;
+        size_t first_sample_idx = 0;
+        for (size_t i = 0; i < cells.size(); ++ i)
+            if (cells[i].sample_cnt > 0) {
+                cells[i].first_sample_idx = first_sample_idx;
+                first_sample_idx += cells[i].sample_cnt;
+                active_cells.emplace_back(i);
             }
+    }
+    std::vector<Vec2f> raw_samples_sorted(raw_samples.size());
+    {
+        std::vector<size_t> cell_fill(cells.size(), 0);
+        for (size_t i = 0; i < raw_samples.size(); ++ i) {
+            size_t idx = raw_sample_cells[i];
+            raw_samples_sorted[cells[idx].first_sample_idx + cell_fill[idx] ++] = raw_samples[i];
         }
     }
-
-    const int   max_trials = 5;
-    const float radius_squared = radius * radius;
-    for (int trial = 0; trial < max_trials; ++ trial) {
-        // Create sample points for each entry in cells.
-        for (auto &it : cells) {
-            const Vec2i          &cell_id   = it.first;
-            PoissonDiskGridEntry &cell_data = it.second;
+    // The raw samples are produced triangle by triangle and the boundary samples last, pick them in a random order
+    // inside each cell.
+    for (size_t idx : active_cells)
+        std::shuffle(raw_samples_sorted.begin() + cells[idx].first_sample_idx,
+                     raw_samples_sorted.begin() + cells[idx].first_sample_idx + cells[idx].sample_cnt, rng);
+    std::shuffle(active_cells.begin(), active_cells.end(), rng);
+
+    const size_t max_trials = 5;
+    const float  radius_squared = radius * radius;
+    for (size_t trial = 0; trial < max_trials; ++ trial) {
+        // Create sample points for each non-empty cell.
+        for (size_t idx : active_cells) {
+            PoissonDiskGridEntry &cell_data = cells[idx];
             // This cell's raw sample points start at first_sample_idx.  On trial 0, try the first one. On trial 1, try first_sample_idx + 1.
-            int next_sample_idx = cell_data.first_sample_idx + trial;
             if (trial >= cell_data.sample_cnt)
                 // There are no more points to try for this cell.
                 continue;
-            const RawSample &candidate = raw_samples_sorted[next_sample_idx];
+            const Vec2f &candidate = raw_samples_sorted[cell_data.first_sample_idx + trial];
+            const Vec2i  cell_id(int(idx % size_t(num_cells.x())), int(idx / size_t(num_cells.x())));
             // See if this point conflicts with any other points in this cell, or with any points in
             // neighboring cells.  Note that it's possible to have more than one point in the same cell.
-            bool conflict = refuse_function(candidate.coord);
-            for (int i = -1; i < 2 && ! conflict; ++ i) {
-                for (int j = -1; j < 2; ++ j) {
-                    const auto &it_neighbor = cells.find(cell_id + Vec2i(i, j));
-                    if (it_neighbor != cells.end()) {
-                        const PoissonDiskGridEntry &neighbor = it_neighbor->second;
-                        for (int i_sample = 0; i_sample < neighbor.num_poisson_samples; ++ i_sample)
-                            if ((neighbor.poisson_samples[i_sample] - candidate.coord).squaredNorm() < radius_squared) {
-                                conflict = true;
-                                break;
-                            }
-                    }
+            bool conflict = false;
+            for (int j = std::max(0, cell_id.y() - 1); j <= std::min(num_cells.y() - 1, cell_id.y() + 1) && ! conflict; ++ j)
+                for (int i = std::max(0, cell_id.x() - 1); i <= std::min(num_cells.x() - 1, cell_id.x() + 1) && ! conflict; ++ i) {
+                    const PoissonDiskGridEntry &neighbor = cells[cell_idx(Vec2i(i, j))];
+                    for (int i_sample = 0; i_sample < neighbor.num_poisson_samples; ++ i_sample)
+                        if ((neighbor.poisson_samples[i_sample] - candidate).squaredNorm() < radius_squared) {
+                            conflict = true;
+                            break;
+                        }
                 }
-            }
-            if (! conflict) {
+            // The refuse function is the more expensive test, call it last.
+            if (! conflict && ! refuse_function(candidate)) {
                 // Store the new sample.
                 assert(cell_data.num_poisson_samples < cell_data.max_positions);
                 if (cell_data.num_poisson_samples < cell_data.max_positions)
-                    cell_data.poisson_samples[cell_data.num_poisson_samples ++] = candidate.coord;
+                    cell_data.poisson_samples[cell_data.num_poisson_samples ++] = candidate;
             }
         }
     }
 
     // Copy the results to the output.
     std::vector<Vec2f> out;
-    for (const auto& it : cells)
-        for (int i = 0; i < it.second.num_poisson_samples; ++ i)
-            out.emplace_back(it.second.poisson_samples[i]);
+    for (size_t idx : active_cells)
+        for (int i = 0; i < cells[idx].num_poisson_samples; ++ i)
+            out.emplace_back(cells[idx].poisson_samples[i]);
     return out;
 }
 
-void SLAAutoSupports::uniformly_cover(const ExPolygons& islands, Structure& structure, PointGrid3D &grid3d, bool is_new_island, bool just_one)
+float SLAAutoSupports::uniformly_cover(const ExPolygons& islands, const Structure& structure, const PointGrid3D &grid3d, std::vector<Vec2f> &samples) const
 {
     //int num_of_points = std::max(1, (int)((island.area()*pow(SCALING_FACTOR, 2) * m_config.tear_pressure)/m_config.support_force));
 
+    samples.clear();
     const float support_force_deficit = structure.support_force_deficit(m_config.tear_pressure());
     if (support_force_deficit < 0)
-        return;
+        return 0.f;
 
     // Number of newly added points.
     const size_t poisson_samples_target = size_t(ceil(support_force_deficit / m_config.support_force()));
@@ -461,15 +618,31 @@ void SLAAutoSupports::uniformly_cover(const ExPolygons& islands, Structure& stru
 //    float min_spacing			= poisson_radius / 3.f;
     float min_spacing			= poisson_radius;
 
-    //FIXME share the random generator. The random generator may be not so cheap to initialize, also we don't want the random generator to be restarted for each polygon.
-    std::random_device  rd;
-    std::mt19937        rng(rd());
+    // Seed the random generator with the layer and island index, so that the islands may be sampled in parallel
+    // and the support points are the same for the same input.
+    const size_t        island_idx = &structure - structure.layer->islands.data();
+    std::seed_seq       seed{ uint32_t(structure.layer->layer_id), uint32_t(island_idx) };
+    std::mt19937        rng(seed);
 	std::vector<Vec2f>  raw_samples = sample_expolygon_with_boundary(islands, samples_per_mm2, 5.f / poisson_radius, rng);
+    if (raw_samples.empty())
+        return min_spacing;
+
+    // Support points of the layers below, which may refuse the samples. They are collected once for all the iterations
+    // below, as min_spacing is only decreasing.
+    Vec2f corner_min(std::numeric_limits<float>::max(), std::numeric_limits<float>::max());
+    Vec2f corner_max(- std::numeric_limits<float>::max(), - std::numeric_limits<float>::max());
+    for (const Vec2f &pt : raw_samples) {
+        corner_min = corner_min.cwiseMin(pt);
+        corner_max = corner_max.cwiseMax(pt);
+    }
+    const PointGrid2D   points_below(grid3d.points_around(corner_min, corner_max, &structure), corner_min, corner_max, min_spacing);
+    const float         z = float(structure.layer->print_z);
+
     std::vector<Vec2f>  poisson_samples;
     for (size_t iter = 0; iter < 4; ++ iter) {
-        poisson_samples = poisson_disk_from_samples(raw_samples, poisson_radius, 
-            [&structure, &grid3d, min_spacing](const Vec2f &pos) {
-                return grid3d.collides_with(pos, &structure, min_spacing);
+        poisson_samples = poisson_disk_from_samples(raw_samples, poisson_radius, rng,
+            [&points_below, z, min_spacing](const Vec2f &pos) {
+                return ! points_below.empty() && points_below.collides_with(Vec3f(pos.x(), pos.y(), z), min_spacing);
             });
         if (poisson_samples.size() >= poisson_samples_target || m_config.minimal_distance > poisson_radius-EPSILON)
             break;
@@ -498,7 +671,15 @@ void SLAAutoSupports::uniformly_cover(const ExPolygons& islands, Structure& stru
 		std::shuffle(poisson_samples.begin(), poisson_samples.end(), rng);
         poisson_samples.erase(poisson_samples.begin() + poisson_samples_target, poisson_samples.end());
     }
-    for (const Vec2f &pt : poisson_samples) {
+    samples = std::move(poisson_samples);
+    return min_spacing;
+}
+
+void SLAAutoSupports::add_support_points(const std::vector<Vec2f> &samples, float min_spacing, Structure& structure, PointGrid3D &grid3d, bool is_new_island, bool check_collisions)
+{
+    for (const Vec2f &pt : samples) {
+        if (check_collisions && grid3d.collides_with(pt, &structure, min_spacing))
+            continue;
         m_output.emplace_back(float(pt(0)), float(pt(1)), structure.height, m_config.head_diameter/2.f, is_new_island);
         structure.supports_force_this_layer += m_config.support_force();
         grid3d.insert(pt, &structure);
@@ -138,7 +138,7 @@ public:
         Vec3f   cell_size;
         Grid    grid;
 
-        Vec3i cell_id(const Vec3f &pos) {
+        Vec3i cell_id(const Vec3f &pos) const {
             return Vec3i(int(floor(pos.x() / cell_size.x())),
                          int(floor(pos.y() / cell_size.y())),
                          int(floor(pos.z() / cell_size.z())));
@@ -151,7 +151,7 @@ public:
             grid.emplace(cell_id(pt.position), pt);
         }
 
-        bool collides_with(const Vec2f &pos, Structure *island, float radius) {
+        bool collides_with(const Vec2f &pos, const Structure *island, float radius) const {
             Vec3f pos3d(pos.x(), pos.y(), float(island->layer->print_z));
             Vec3i cell = cell_id(pos3d);
             std::pair<Grid::const_iterator, Grid::const_iterator> it_pair = grid.equal_range(cell);
@@ -169,8 +169,26 @@ public:
             return false;
         }
 
+        // Collect the positions of all the points, which collides_with() may test for a point of the island
+        // inside the <corner_min, corner_max> rectangle. The grid is only read, therefore this may be called
+        // from multiple threads at once.
+        std::vector<Vec3f> points_around(const Vec2f &corner_min, const Vec2f &corner_max, const Structure *island) const {
+            std::vector<Vec3f> out;
+            const float z = float(island->layer->print_z);
+            Vec3i cell_min = cell_id(Vec3f(corner_min.x(), corner_min.y(), z)) - Vec3i(1, 1, 1);
+            Vec3i cell_max = cell_id(Vec3f(corner_max.x(), corner_max.y(), z)) + Vec3i(1, 1, 0);
+            for (int k = cell_min.z(); k <= cell_max.z(); ++ k)
+                for (int j = cell_min.y(); j <= cell_max.y(); ++ j)
+                    for (int i = cell_min.x(); i <= cell_max.x(); ++ i) {
+                        std::pair<Grid::const_iterator, Grid::const_iterator> it_pair = grid.equal_range(Vec3i(i, j, k));
+                        for (Grid::const_iterator it = it_pair.first; it != it_pair.second; ++ it)
+                            out.emplace_back(it->second.position);
+                    }
+            return out;
+        }
+
     private:
-        bool collides_with(const Vec3f &pos, float radius, Grid::const_iterator it_begin, Grid::const_iterator it_end) {
+        bool collides_with(const Vec3f &pos, float radius, Grid::const_iterator it_begin, Grid::const_iterator it_end) const {
             for (Grid::const_iterator it = it_begin; it != it_end; ++ it) {
 				float dist2 = (it->second.position - pos).squaredNorm();
                 if (dist2 < radius * radius)
@@ -188,7 +206,13 @@ private:
     float m_supports_force_total = 0.f;
 
     void process(const std::vector<ExPolygons>& slices, const std::vector<float>& heights);
-    void uniformly_cover(const ExPolygons& islands, Structure& structure, PointGrid3D &grid3d, bool is_new_island = false, bool just_one = false);
+    // Sample the islands of the structure with new support points, refusing the samples colliding with the points of grid3d.
+    // Only reads the structure and the grid, so the structures of a single layer may be covered in parallel.
+    // Returns the minimal spacing the samples were refused with.
+    float uniformly_cover(const ExPolygons& islands, const Structure& structure, const PointGrid3D &grid3d, std::vector<Vec2f> &samples) const;
+    // Add the samples produced by uniformly_cover() as support points, skipping samples colliding with the support points
+    // added to the layer by the other structures since grid3d was sampled.
+    void add_support_points(const std::vector<Vec2f> &samples, float min_spacing, Structure& structure, PointGrid3D &grid3d, bool is_new_island, bool check_collisions);
     void project_onto_mesh(std::vector<sla::SupportPoint>& points) const;
 
 #ifdef SLA_AUTOSUPPORTS_DEBUG
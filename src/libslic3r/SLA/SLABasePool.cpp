@@ -715,23 +715,24 @@ void base_plate(const TriangleMesh &mesh,
     base_plate(mesh, output, heights, thrfn);
 }
 
-Contour3D create_base_pool(const Polygons &ground_layer, 
-                           const ExPolygons &obj_self_pad = {},
-                           const PoolConfig& cfg = PoolConfig()) 
+Polygons base_pool_outline(const Polygons &ground_layer, const PoolConfig& cfg)
 {
-    // for debugging:
-    // Benchmark bench;
-    // bench.start();
-
-    double mergedist = 2*(1.8*cfg.min_wall_thickness_mm + 4*cfg.edge_radius_mm)+
-                       cfg.max_merge_distance_mm;
-
     // Here we get the base polygon from which the pad has to be generated.
     // We create an artificial concave hull from this polygon and that will
     // serve as the bottom plate of the pad. We will offset this concave hull
     // and then offset back the result with clipper with rounding edges ON. This
     // trick will create a nice rounded pad shape.
-    Polygons concavehs = concave_hull(ground_layer, mergedist, cfg.throw_on_cancel);
+    return concave_hull(ground_layer, get_pad_merge_distance(cfg),
+                        cfg.throw_on_cancel);
+}
+
+Contour3D create_base_pool(const Polygons &outline,
+                           const ExPolygons &obj_self_pad = {},
+                           const PoolConfig& cfg = PoolConfig()) 
+{
+    // for debugging:
+    // Benchmark bench;
+    // bench.start();
 
     const double thickness      = cfg.min_wall_thickness_mm;
     const double wingheight     = cfg.min_wall_height_mm;
@@ -749,6 +750,16 @@ Contour3D create_base_pool(const Polygons &ground_layer,
 
     auto& thrcl = cfg.throw_on_cancel;
 
+    // The pad is offsetted far outside of its outline so the outline can be
+    // simplified with a tolerance proportional to that offset without
+    // uncovering the base plate. The cost of the offsets, walls and plate
+    // triangulations below is driven by the number of the outline vertices.
+    const double simplify_tol = std::max(
+        scaled<double>(0.01), 0.02 * (s_safety_dist + s_wingdist + s_thickness));
+
+    Polygons concavehs;
+    for(const Polygon& p : outline) p.simplify(simplify_tol, concavehs);
+
     Contour3D pool;
 
     for(Polygon& concaveh : concavehs) {
@@ -916,7 +927,15 @@ void create_base_pool(const Polygons &ground_layer, TriangleMesh& out,
     // std::fstream fout("pad_debug.obj", std::fstream::out);
     // if(fout.good()) pool.to_obj(fout);
 
-    out.merge(mesh(create_base_pool(ground_layer, holes, cfg)));
+    create_base_pool_from_outline(base_pool_outline(ground_layer, cfg), out,
+                                  holes, cfg);
+}
+
+void create_base_pool_from_outline(const Polygons &outline, TriangleMesh& out,
+                                   const ExPolygons &holes,
+                                   const PoolConfig& cfg)
+{
+    out.merge(mesh(create_base_pool(outline, holes, cfg)));
 }
 
 }
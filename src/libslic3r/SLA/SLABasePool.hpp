@@ -73,6 +73,20 @@ void create_base_pool(const Polygons& base_plate,
                       const ExPolygons& holes,
                       const PoolConfig& = PoolConfig());
 
+/// Calculate the outline of the pool: the concave hull connecting the islands
+/// of the base plate. This is the most expensive part of the pool creation and
+/// it only depends on the base plate and get_pad_merge_distance(), so it can
+/// be kept and reused with create_base_pool_from_outline().
+Polygons base_pool_outline(const Polygons& base_plate,
+                           const PoolConfig& = PoolConfig());
+
+/// Calculate the pool for the mesh for SLA printing from the outline returned
+/// by base_pool_outline()
+void create_base_pool_from_outline(const Polygons& outline,
+                                   TriangleMesh& output_mesh,
+                                   const ExPolygons& holes,
+                                   const PoolConfig& = PoolConfig());
+
 /// Returns the elevation needed for compensating the pad.
 inline double get_pad_elevation(const PoolConfig& cfg) {
     return cfg.min_wall_thickness_mm;
@@ -82,6 +96,13 @@ inline double get_pad_fullheight(const PoolConfig& cfg) {
     return cfg.min_wall_height_mm + cfg.min_wall_thickness_mm;
 }
 
+/// Returns the distance of the islands of the base plate up to which they are
+/// connected into a single pad.
+inline double get_pad_merge_distance(const PoolConfig& cfg) {
+    return 2*(1.8*cfg.min_wall_thickness_mm + 4*cfg.edge_radius_mm) +
+           cfg.max_merge_distance_mm;
+}
+
 }
 
 }
@@ -3,6 +3,7 @@
 
 #include <Eigen/Geometry>
 #include <memory>
+#include <vector>
 
 // #define SLIC3R_SLA_NEEDS_WINDTREE
 
@@ -64,7 +65,9 @@ class EigenMesh3D {
     Eigen::MatrixXi m_F;
     double m_ground_level = 0, m_gnd_offset = 0;
 
-    std::unique_ptr<AABBImpl> m_aabb;
+    // The AABB tree is not modified after construction, copies of the mesh
+    // share it.
+    std::shared_ptr<AABBImpl> m_aabb;
 public:
 
     EigenMesh3D(const TriangleMesh&);
@@ -127,6 +130,11 @@ public:
     // Casting a ray on the mesh, returns the distance where the hit occures.
     hit_result query_ray_hit(const Vec3d &s, const Vec3d &dir) const;
 
+    // Casting a batch of rays on the mesh in parallel. The i-th result
+    // belongs to the ray starting at sources[i] in the direction dirs[i].
+    std::vector<hit_result> query_ray_hits(const std::vector<Vec3d> &sources,
+                                           const std::vector<Vec3d> &dirs) const;
+
     class si_result {
         double m_value;
         int m_fidx;
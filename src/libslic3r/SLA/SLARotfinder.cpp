@@ -1,5 +1,9 @@
 #include <limits>
 #include <exception>
+#include <unordered_map>
+
+#include <tbb/parallel_reduce.h>
+#include <tbb/blocked_range.h>
 
 #include <libnest2d/optimizers/nlopt/genetic.hpp>
 #include "SLABoilerPlate.hpp"
@@ -10,10 +14,143 @@
 namespace Slic3r {
 namespace sla {
 
+namespace {
+
+// The mesh reduced to the histogram of its facet normals. The normals are
+// quantized into cells of the given resolution, every cell holds the mean
+// normal of its facets with the number and the summed area of these facets.
+// The rotation objectives depend only on the orientation of the facets, so
+// they are evaluated on the histogram instead of the whole mesh.
+class NormalHistogram {
+    Eigen::Matrix<double, Eigen::Dynamic, 3> m_normals;
+    Eigen::VectorXd m_counts;
+    Eigen::VectorXd m_areas;
+
+    // Rows processed by a single task when evaluating an objective
+    static const size_t GRAINSIZE = 4096;
+
+    // Sum up fn(rotated normals, counts, areas) over blocks of the histogram
+    template<class Fn> double reduce(const Eigen::Matrix3d &rot, Fn fn) const
+    {
+        Eigen::Matrix3d rt = rot.transpose();
+        return tbb::parallel_reduce(
+            tbb::blocked_range<size_t>(0, size_t(m_normals.rows()), GRAINSIZE),
+            0.,
+            [this, &rt, &fn](const tbb::blocked_range<size_t> &range, double sum) {
+                auto from = Eigen::Index(range.begin());
+                auto n    = Eigen::Index(range.size());
+                Eigen::Matrix<double, Eigen::Dynamic, 3> rn =
+                    m_normals.middleRows(from, n) * rt;
+                return sum + fn(rn, m_counts.segment(from, n),
+                                m_areas.segment(from, n));
+            },
+            std::plus<double>());
+    }
+
+public:
+
+    NormalHistogram(const TriangleMesh &mesh, double resolution)
+    {
+        const stl_file &stl = mesh.stl;
+        auto nfacets = size_t(stl.stats.number_of_facets);
+
+        std::vector<Vec3d> normals;
+        std::vector<double> counts, areas;
+        std::unordered_map<int64_t, size_t> cells;
+
+        for (size_t i = 0; i < nfacets; ++i) {
+            const stl_facet &facet = stl.facet_start[i];
+            Vec3d p1 = facet.vertex[0].cast<double>();
+            Vec3d n = (facet.vertex[1].cast<double>() - p1).cross(
+                       facet.vertex[2].cast<double>() - p1);
+
+            // Twice the area of the facet
+            double a2 = n.norm();
+            if (a2 <= 0.) continue;
+            n /= a2;
+
+            int64_t key = 0;
+            for (int c = 0; c < 3; ++c)
+                key = (key << 20) + int64_t(std::round(n(c) / resolution)) +
+                      (1 << 19);
+
+            auto it = cells.emplace(key, normals.size());
+            if (it.second) {
+                normals.emplace_back(Vec3d::Zero());
+                counts.emplace_back(0.);
+                areas.emplace_back(0.);
+            }
+
+            size_t cell = it.first->second;
+            normals[cell] += n;
+            counts[cell] += 1.;
+            areas[cell] += 0.5 * a2;
+        }
+
+        m_normals.resize(Eigen::Index(normals.size()), 3);
+        m_counts.resize(Eigen::Index(normals.size()));
+        m_areas.resize(Eigen::Index(normals.size()));
+        for (size_t i = 0; i < normals.size(); ++i) {
+            auto row = Eigen::Index(i);
+            m_normals.row(row) = normals[i].normalized();
+            m_counts(row) = counts[i];
+            m_areas(row) = areas[i];
+        }
+    }
+
+    size_t size() const { return size_t(m_normals.rows()); }
+
+    // Sum of the alignments of the facet normals with the three axes.
+    double axis_alignment(const Eigen::Matrix3d &rot) const
+    {
+        return reduce(rot, [](const Eigen::Matrix<double, Eigen::Dynamic, 3> &rn,
+                              const Eigen::VectorXd &counts,
+                              const Eigen::VectorXd &) {
+            return rn.cwiseAbs().rowwise().sum().dot(counts);
+        });
+    }
+
+    // Area of the downward facing facets which need supports: the facets with
+    // the normal pointing more than the given angle below the horizontal plane,
+    // that is the facets flatter than (90 degrees - angle) from the horizontal.
+    double overhang_area(const Eigen::Matrix3d &rot, double angle) const
+    {
+        double zlimit = -std::sin(angle);
+        return reduce(rot, [zlimit](const Eigen::Matrix<double, Eigen::Dynamic, 3> &rn,
+                                    const Eigen::VectorXd &,
+                                    const Eigen::VectorXd &areas) {
+            return (rn.col(2).array() < zlimit).cast<double>().matrix().dot(areas);
+        });
+    }
+
+    // Half of the summed area of the facets projected to the XY plane. For
+    // a closed mesh this is the area of its XY projection weighted by the
+    // number of times a vertical line enters the mesh, therefore it equals
+    // the projected area only for convex meshes.
+    double projected_facet_area(const Eigen::Matrix3d &rot) const
+    {
+        return 0.5 * reduce(rot, [](const Eigen::Matrix<double, Eigen::Dynamic, 3> &rn,
+                                    const Eigen::VectorXd &,
+                                    const Eigen::VectorXd &areas) {
+            return rn.col(2).cwiseAbs().dot(areas);
+        });
+    }
+};
+
+// Size of the cells of the normal histogram
+static const double NORMAL_RESOLUTION = 1. / 128;
+
+// Downward facing facets flatter than 45 degrees from the horizontal plane
+// are considered overhangs by the min_overhangs objective.
+static const double OVERHANG_ANGLE = PI / 4;
+
+}
+
 std::array<double, 3> find_best_rotation(const ModelObject& modelobj,
                                          float accuracy,
                                          std::function<void(unsigned)> statuscb,
-                                         std::function<bool()> stopcond)
+                                         std::function<bool()> stopcond,
+                                         RotationObjective objective)
 {
     using libnest2d::opt::Method;
     using libnest2d::opt::bound;
@@ -26,9 +163,9 @@ std::array<double, 3> find_best_rotation(const ModelObject& modelobj,
     // return value
     std::array<double, 3> rot;
 
-    // We will use only one instance of this converted mesh to examine different
-    // rotations
-    EigenMesh3D emesh(modelobj.raw_mesh());
+    // The mesh is reduced to the histogram of its normals once, the solver
+    // examines the different rotations on this compact data.
+    NormalHistogram histogram(modelobj.raw_mesh(), NORMAL_RESOLUTION);
 
     // For current iteration number
     unsigned status = 0;
@@ -44,11 +181,10 @@ std::array<double, 3> find_best_rotation(const ModelObject& modelobj,
     // call the status callback in each iteration but the actual value may be
     // the same for subsequent iterations (status goes from 0 to 100 but
     // iterations can be many more)
-    auto objfunc = [&emesh, &status, &statuscb, &stopcond, max_tries]
+    auto objfunc = [&histogram, &status, &statuscb, &stopcond, max_tries,
+                    objective]
             (double rx, double ry, double rz)
     {
-        EigenMesh3D& m = emesh;
-
         // prepare the rotation transformation
         Transform3d rt = Transform3d::Identity();
 
@@ -58,36 +194,22 @@ std::array<double, 3> find_best_rotation(const ModelObject& modelobj,
 
         double score = 0;
 
-        // For all triangles we calculate the normal and sum up the dot product
-        // (a scalar indicating how much are two vectors aligned) with each axis
-        // this will result in a value that is greater if a normal is aligned
-        // with all axes. If the normal is aligned than the triangle itself is
-        // orthogonal to the axes and that is good for print quality.
-
-        // TODO: some applications optimize for minimum z-axis cross section
-        // area. The current function is only an example of how to optimize.
-
-        // Later we can add more criteria like the number of overhangs, etc...
-        for(int i = 0; i < m.F().rows(); i++) {
-            auto idx = m.F().row(i);
-
-            Vec3d p1 = m.V().row(idx(0));
-            Vec3d p2 = m.V().row(idx(1));
-            Vec3d p3 = m.V().row(idx(2));
-
-            Eigen::Vector3d U = p2 - p1;
-            Eigen::Vector3d V = p3 - p1;
-
-            // So this is the normal
-            auto n = U.cross(V).normalized();
-
-            // rotate the normal with the current rotation given by the solver
-            n = rt * n;
-
-            // We should score against the alignment with the reference planes
-            score += std::abs(n.dot(Vec3d::UnitX()));
-            score += std::abs(n.dot(Vec3d::UnitY()));
-            score += std::abs(n.dot(Vec3d::UnitZ()));
+        switch (objective) {
+        case RotationObjective::axis_alignment:
+            // For all facets we sum up the dot product of the normal (a
+            // scalar indicating how much are two vectors aligned) with each
+            // axis. This will result in a value that is greater if a normal
+            // is aligned with all axes. If the normal is aligned than the
+            // triangle itself is orthogonal to the axes and that is good for
+            // print quality.
+            score = histogram.axis_alignment(rt.linear());
+            break;
+        case RotationObjective::min_overhangs:
+            score = -histogram.overhang_area(rt.linear(), OVERHANG_ANGLE);
+            break;
+        case RotationObjective::min_projected_facet_area:
+            score = -histogram.projected_facet_area(rt.linear());
+            break;
         }
 
         // report status
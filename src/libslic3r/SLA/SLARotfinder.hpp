@@ -10,6 +10,13 @@ class ModelObject;
 
 namespace sla {
 
+// The criteria the rotation finder can optimize for.
+enum class RotationObjective {
+    axis_alignment,     // Facets aligned with the reference planes
+    min_overhangs,      // Least area of downward facing steep facets
+    min_projected_facet_area // Least summed area of the facets projected to the XY plane
+};
+
 /**
   * The function should find the best rotation for SLA upside down printing.
   *
@@ -22,6 +29,8 @@ namespace sla {
   * an optimum before max iterations are reached.
   * @param stopcond A function that if returns true, the search process will be
   * terminated and the best solution found will be returned.
+  * @param objective The criterion to optimize for. All the objectives are
+  * evaluated on a histogram of the facet normals computed once per call.
   *
   * @return Returns the rotations around each axis (x, y, z)
   */
@@ -29,7 +38,8 @@ std::array<double, 3> find_best_rotation(
         const ModelObject& modelobj,
         float accuracy = 1.0f,
         std::function<void(unsigned)> statuscb = [] (unsigned) {},
-        std::function<bool()> stopcond = [] () { return false; }
+        std::function<bool()> stopcond = [] () { return false; },
+        RotationObjective objective = RotationObjective::axis_alignment
         );
 
 }
@@ -11,12 +11,14 @@
 
 #include <libslic3r/MTUtils.hpp>
 #include <libslic3r/ClipperUtils.hpp>
+#include <libslic3r/Geometry.hpp>
 #include <libslic3r/Model.hpp>
 
 #include <libnest2d/optimizers/nlopt/genetic.hpp>
 #include <libnest2d/optimizers/nlopt/subplex.hpp>
 #include <boost/log/trivial.hpp>
 #include <tbb/parallel_for.h>
+#include <tbb/task_arena.h>
 #include <libslic3r/I18N.hpp>
 
 //! macro used to mark string used at localization,
@@ -253,8 +255,154 @@ Contour3D cylinder(double r, double h, size_t ssteps, const Vec3d sp = {0,0,0})
     return ret;
 }
 
+// Analytic description of a part of the support geometry. It is kept next to
+// the tessellated mesh of the support parts and it is used to slice the
+// supports without slicing the (potentially huge) merged support mesh: every
+// primitive is intersected with the slicing plane directly.
+struct Primitives {
+
+    // Sphere, optionally clipped by horizontal planes zmin and zmax given
+    // relative to its center (see the portion argument of sphere()).
+    struct Sphere {
+        Vec3d  center;
+        double r;
+        double zmin, zmax;
+        size_t steps;
+    };
+
+    // Truncated cone between the circles at p1 and p2 perpendicular to the
+    // p1 -> p2 axis. Cylinders have r1 == r2.
+    struct Frustum {
+        Vec3d  p1, p2;
+        double r1, r2;
+        size_t steps;
+    };
+
+    std::vector<Sphere>  spheres;
+    std::vector<Frustum> frusta;
+
+    void add_sphere(const Vec3d &center, double r, size_t steps,
+                    Portion portion = make_portion(0, PI))
+    {
+        if(r <= 1e-6) return;
+        spheres.push_back({center, r,
+                           -r + 2 * r * std::get<0>(portion) / PI,
+                           -r + 2 * r * std::get<1>(portion) / PI,
+                           steps});
+    }
+
+    void add_frustum(const Vec3d &p1, const Vec3d &p2, double r1, double r2,
+                     size_t steps)
+    {
+        if((p2 - p1).squaredNorm() <= EPSILON * EPSILON) return;
+        frusta.push_back({p1, p2, r1, r2, steps});
+    }
+
+    void merge(const Primitives &other)
+    {
+        spheres.insert(spheres.end(), other.spheres.begin(), other.spheres.end());
+        frusta.insert(frusta.end(), other.frusta.begin(), other.frusta.end());
+    }
+
+    void clear() { spheres.clear(); frusta.clear(); }
+
+    bool empty() const { return spheres.empty() && frusta.empty(); }
+
+    // Append the cross sections of the primitives with the plane at height z
+    // to the output. The cross sections overlap, the caller has to union them.
+    void slice(double z, Polygons &out) const
+    {
+        for(const Sphere &s : spheres) {
+            double dz = z - s.center(Z);
+            if(dz < s.zmin || dz > s.zmax || std::abs(dz) >= s.r) continue;
+            out.emplace_back(circle(s.center, std::sqrt(s.r * s.r - dz * dz),
+                                    s.steps));
+        }
+
+        for(const Frustum &f : frusta) slice(f, z, out);
+    }
+
+private:
+
+    static Polygon circle(const Vec3d &c, double r, size_t steps)
+    {
+        Polygon ret;
+        if(steps < 3) steps = 3;
+        ret.points.reserve(steps);
+        double a = 2 * PI / steps;
+        for(size_t i = 0; i < steps; ++i) {
+            double phi = i * a;
+            ret.points.emplace_back(coord_t(scale_(c(X) + r * std::cos(phi))),
+                                    coord_t(scale_(c(Y) + r * std::sin(phi))));
+        }
+        return ret;
+    }
+
+    static void slice(const Frustum &f, double z, Polygons &out)
+    {
+        Vec3d  axis = f.p2 - f.p1;
+        double len  = axis.norm();
+        axis /= len;
+
+        // Vertical extent of the end circles
+        double sz = std::sqrt(std::max(0., 1. - axis(Z) * axis(Z)));
+        double zmin = std::min(f.p1(Z) - f.r1 * sz, f.p2(Z) - f.r2 * sz);
+        double zmax = std::max(f.p1(Z) + f.r1 * sz, f.p2(Z) + f.r2 * sz);
+        if(z < zmin || z > zmax) return;
+
+        if(sz < EPSILON) {
+            // Vertical axis (pillars and their bases): the section is a circle
+            double t = (z - f.p1(Z)) / (f.p2(Z) - f.p1(Z));
+            Vec3d  c = f.p1 + t * (f.p2 - f.p1);
+            out.emplace_back(circle(c, f.r1 + t * (f.r2 - f.r1), f.steps));
+            return;
+        }
+
+        // Tilted axis: the section is a conic clipped by the end circles.
+        // Intersect the plane with the edges of the same tessellation the
+        // mesh is generated with, the section of the convex body is the
+        // convex hull of the intersection points.
+        Vec3d u = axis.cross(Vec3d::UnitZ()).normalized();
+        Vec3d v = axis.cross(u);
+
+        size_t steps = std::max(f.steps, size_t(3));
+        double a = 2 * PI / steps;
+
+        Points pts;
+        auto isect = [z, &pts](const Vec3d &p, const Vec3d &q) {
+            double dp = p(Z) - z, dq = q(Z) - z;
+            if((dp > 0 && dq > 0) || (dp < 0 && dq < 0)) return;
+            Vec3d is = std::abs(dp - dq) < 1e-12 ?
+                           p : Vec3d(p + (dp / (dp - dq)) * (q - p));
+            pts.emplace_back(coord_t(scale_(is(X))), coord_t(scale_(is(Y))));
+        };
+
+        auto ringpt = [&f, &u, &v, a](size_t i, bool upper) {
+            double phi = i * a;
+            Vec3d  d = std::cos(phi) * u + std::sin(phi) * v;
+            return upper ? Vec3d(f.p2 + f.r2 * d) : Vec3d(f.p1 + f.r1 * d);
+        };
+
+        Vec3d l0 = ringpt(0, false), u0 = ringpt(0, true);
+        Vec3d lprev = l0, uprev = u0;
+        for(size_t i = 0; i < steps; ++i) {
+            Vec3d lnext = i + 1 < steps ? ringpt(i + 1, false) : l0;
+            Vec3d unext = i + 1 < steps ? ringpt(i + 1, true) : u0;
+            isect(lprev, uprev);
+            isect(lprev, lnext);
+            isect(uprev, unext);
+            lprev = lnext; uprev = unext;
+        }
+
+        if(pts.size() < 3) return;
+        Polygon hull = Geometry::convex_hull(std::move(pts));
+        if(hull.points.size() >= 3) out.emplace_back(std::move(hull));
+    }
+};
+
 struct Head {
     Contour3D mesh;
+    Primitives shape;
 
     size_t steps = 45;
     Vec3d dir = {0, 0, -1};
@@ -338,6 +486,20 @@ struct Head {
         // To simplify further processing, we translate the mesh so that the
         // last vertex of the pointing sphere (the pinpoint) will be at (0,0,0)
         for(auto& p : mesh.points) z(p) -= (h + r_small_mm - penetration_mm);
+
+        // The same solid described analytically in the final position: the
+        // two whole spheres and the cone touching both of them. The portions
+        // of the spheres left out from the mesh are inside the cone.
+        Vec3d n = dir.normalized();
+        Vec3d c_big = tr + (h + r_small_mm - penetration_mm) * n;
+        Vec3d c_small = tr + (r_small_mm - penetration_mm) * n;
+        double cosa = (r_big_mm - r_small_mm) / h;
+        double sina = std::sqrt(std::max(0., 1. - cosa * cosa));
+        shape.add_sphere(c_big, r_big_mm, steps);
+        shape.add_sphere(c_small, r_small_mm, steps);
+        shape.add_frustum(c_big - r_big_mm * cosa * n,
+                          c_small - r_small_mm * cosa * n,
+                          r_big_mm * sina, r_small_mm * sina, steps);
     }
 
     void transform()
@@ -374,6 +536,7 @@ struct Head {
 
 struct Junction {
     Contour3D mesh;
+    Primitives shape;
     double r = 1;
     size_t steps = 45;
     Vec3d pos;
@@ -385,12 +548,15 @@ struct Junction {
     {
         mesh = sphere(r_mm, make_portion(0, PI), 2*PI/steps);
         for(auto& p : mesh.points) p += tr;
+        shape.add_sphere(tr, r_mm, steps);
     }
 };
 
 struct Pillar {
     Contour3D mesh;
     Contour3D base;
+    Primitives shape;
+    Primitives base_shape;
     double r = 1;
     size_t steps = 0;
     Vec3d endpt;
@@ -422,6 +588,7 @@ struct Pillar {
             Contour3D body = cylinder(radius, height, st, endp);
             mesh.points.swap(body.points);
             mesh.indices.swap(body.indices);
+            shape.add_frustum(endp, startpoint(), radius, radius, st);
         }
     }
 
@@ -485,6 +652,8 @@ struct Pillar {
         indices.emplace_back(last, offs + last, offs);
         indices.emplace_back(hcenter, last, 0);
         indices.emplace_back(offs, offs + last, lcenter);
+
+        base_shape.add_frustum(endpt, ep, radius, r, steps);
         return *this;
     }
 
@@ -494,6 +663,7 @@ struct Pillar {
 // A Bridge between two pillars (with junction endpoints)
 struct Bridge {
     Contour3D mesh;
+    Primitives shape;
     double r = 0.8;
 
     long id = -1;
@@ -513,6 +683,8 @@ struct Bridge {
 
         auto quater = Quaternion::FromTwoVectors(Vec3d{0,0,1}, dir);
         for(auto& p : mesh.points) p = quater * p + j1;
+
+        shape.add_frustum(j1, j2, r, r, steps);
     }
 
     Bridge(const Junction& j1, const Junction& j2, double r_mm = 0.8):
@@ -524,6 +696,7 @@ struct Bridge {
 // edges on the endpoints. Used for headless support points.
 struct CompactBridge {
     Contour3D mesh;
+    Primitives shape;
     long id = -1;
 
     CompactBridge(const Vec3d& sp,
@@ -539,22 +712,56 @@ struct CompactBridge {
 
         Bridge br(startp, endp, r, steps);
         mesh.merge(br.mesh);
+        shape.merge(br.shape);
 
         // now add the pins
         double fa = 2*PI/steps;
         auto upperball = sphere(r, Portion{PI / 2 - fa, PI}, fa);
         for(auto& p : upperball.points) p += startp;
+        shape.add_sphere(startp, r, steps, Portion{PI / 2 - fa, PI});
         
         if(endball) {
             auto lowerball = sphere(r, Portion{0, PI/2 + 2*fa}, fa);
             for(auto& p : lowerball.points) p += endp;
             mesh.merge(lowerball);
+            shape.add_sphere(endp, r, steps, Portion{0, PI/2 + 2*fa});
         }
         
         mesh.merge(upperball);
     }
 };
 
+// The outline of the pad (see base_pool_outline()) is the most expensive part
+// of the pad creation. It is kept for the next pad which is usually created
+// after changing a pad parameter not affecting the outline, like the wall
+// height or slope.
+struct PadOutlineCache {
+    Polygons base_plate;
+    double   merge_dist = -1.;
+    Polygons outline;
+
+    const Polygons& get(const Polygons& basep, const PoolConfig& cfg)
+    {
+        auto same_polygons = [](const Polygons& a, const Polygons& b) {
+            if(a.size() != b.size()) return false;
+            for(size_t i = 0; i < a.size(); ++i)
+                if(a[i].points != b[i].points) return false;
+            return true;
+        };
+
+        double md = get_pad_merge_distance(cfg);
+        if(md != merge_dist || !same_polygons(basep, base_plate)) {
+            // Keep the cache invalid if the calculation gets canceled
+            merge_dist = -1.;
+            outline    = base_pool_outline(basep, cfg);
+            base_plate = basep;
+            merge_dist = md;
+        }
+
+        return outline;
+    }
+};
+
 // A wrapper struct around the base pool (pad)
 struct Pad {
     TriangleMesh tmesh;
@@ -563,10 +770,11 @@ struct Pad {
 
     Pad() = default;
 
-    Pad(const TriangleMesh& support_mesh,
+    Pad(const Primitives& support_shape,
         const ExPolygons& modelbase,
         double ground_level,
-        const PoolConfig& pcfg) :
+        const PoolConfig& pcfg,
+        PadOutlineCache& outline_cache) :
         cfg(pcfg),
         zlevel(ground_level + 
                sla::get_pad_fullheight(pcfg) -
@@ -577,18 +785,23 @@ struct Pad {
         
         thr();
         
-        // Get a sample for the pad from the support mesh
+        // Get a sample for the pad from the support structures. The support
+        // primitives are intersected with the sampling planes analytically,
+        // which is much cheaper than slicing the merged support mesh.
         {
-            ExPolygons platetmp;
-
             float zstart = float(zlevel);
             float zend   = zstart + float(get_pad_fullheight(pcfg) + EPSILON);
 
-            base_plate(support_mesh, platetmp, grid(zstart, zend, 0.1f), thr);
+            Polygons samples;
+            for(float z : grid(zstart, zend, 0.1f)) {
+                thr();
+                support_shape.slice(double(z), samples);
+            }
 
             // We don't need no... holes control...
-            for (const ExPolygon &bp : platetmp)
-                basep.emplace_back(std::move(bp.contour));
+            for (const ExPolygon &bp : union_ex(samples))
+                for (ExPolygon &smp : bp.simplify(scaled<double>(0.1)))
+                    basep.emplace_back(std::move(smp.contour));
         }
         
         if(pcfg.embed_object) {
@@ -660,10 +873,12 @@ struct Pad {
                 }
             }
             
-            create_base_pool(basep, tmesh, pad_stickholes, cfg);
+            create_base_pool_from_outline(outline_cache.get(basep, cfg), tmesh,
+                                          pad_stickholes, cfg);
         } else {
             for (const ExPolygon &bp : modelbase) basep.emplace_back(bp.contour);
-            create_base_pool(basep, tmesh, {}, cfg);
+            create_base_pool_from_outline(outline_cache.get(basep, cfg), tmesh,
+                                          {}, cfg);
         }
 
         tmesh.translate(0, 0, float(zlevel));
@@ -733,7 +948,9 @@ class SLASupportTree::Impl {
     Controller m_ctl;
 
     Pad m_pad;
+    PadOutlineCache m_pad_outline;
     mutable TriangleMesh meshcache; mutable bool meshcache_valid = false;
+    mutable Primitives shapecache; mutable bool shapecache_valid = false;
     mutable double model_height = 0; // the full height of the model
 public:
     double ground_level = 0;
@@ -748,7 +965,7 @@ public:
                             std::forward_as_tuple(id),
                             std::forward_as_tuple(std::forward<Args>(args)...));
         el.first->second.id = id;
-        meshcache_valid = false;
+        meshcache_valid = false; shapecache_valid = false;
         return el.first->second;
     }
 
@@ -762,7 +979,7 @@ public:
         head.pillar_id = pillar.id;
         pillar.start_junction_id = head.id;
         pillar.starts_from_head = true;
-        meshcache_valid = false;
+        meshcache_valid = false; shapecache_valid = false;
         return m_pillars.back();
     }
 
@@ -786,7 +1003,7 @@ public:
         Pillar& pillar = m_pillars.back();
         pillar.id = long(m_pillars.size() - 1);
         pillar.starts_from_head = false;
-        meshcache_valid = false;
+        meshcache_valid = false; shapecache_valid = false;
         return m_pillars.back();
     }
 
@@ -810,14 +1027,14 @@ public:
     template<class...Args> const Junction& add_junction(Args&&... args) {
         m_junctions.emplace_back(std::forward<Args>(args)...);
         m_junctions.back().id = long(m_junctions.size() - 1);
-        meshcache_valid = false;
+        meshcache_valid = false; shapecache_valid = false;
         return m_junctions.back();
     }
 
     template<class...Args> const Bridge& add_bridge(Args&&... args) {
         m_bridges.emplace_back(std::forward<Args>(args)...);
         m_bridges.back().id = long(m_bridges.size() - 1);
-        meshcache_valid = false;
+        meshcache_valid = false; shapecache_valid = false;
         return m_bridges.back();
     }
 
@@ -825,13 +1042,13 @@ public:
     const CompactBridge& add_compact_bridge(Args&&...args) {
         m_compact_bridges.emplace_back(std::forward<Args>(args)...);
         m_compact_bridges.back().id = long(m_compact_bridges.size() - 1);
-        meshcache_valid = false;
+        meshcache_valid = false; shapecache_valid = false;
         return m_compact_bridges.back();
     }
 
     const std::map<unsigned, Head>& heads() const { return m_heads; }
     Head& head(unsigned idx) {
-        meshcache_valid = false;
+        meshcache_valid = false; shapecache_valid = false;
         auto it = m_heads.find(idx);
         assert(it != m_heads.end());
         return it->second;
@@ -850,10 +1067,10 @@ public:
         return m_pillars[size_t(id)];
     }
 
-    const Pad& create_pad(const TriangleMesh& object_supports,
-                          const ExPolygons& modelbase,
+    const Pad& create_pad(const ExPolygons& modelbase,
                           const PoolConfig& cfg) {
-        m_pad = Pad(object_supports, modelbase, ground_level, cfg);
+        m_pad = Pad(merged_shape(), modelbase, ground_level, cfg,
+                    m_pad_outline);
         return m_pad;
     }
 
@@ -918,6 +1135,48 @@ public:
         return meshcache;
     }
 
+    // The analytic description of the merged mesh, WITHOUT THE PAD!!!
+    const Primitives& merged_shape() const {
+        if(shapecache_valid) return shapecache;
+
+        shapecache.clear();
+
+        for(auto& headel : heads()) {
+            if(m_ctl.stopcondition()) break;
+            if(headel.second.is_valid())
+                shapecache.merge(headel.second.shape);
+        }
+
+        for(auto& stick : pillars()) {
+            if(m_ctl.stopcondition()) break;
+            shapecache.merge(stick.shape);
+            shapecache.merge(stick.base_shape);
+        }
+
+        for(auto& j : junctions()) {
+            if(m_ctl.stopcondition()) break;
+            shapecache.merge(j.shape);
+        }
+
+        for(auto& cb : compact_bridges()) {
+            if(m_ctl.stopcondition()) break;
+            shapecache.merge(cb.shape);
+        }
+
+        for(auto& bs : bridges()) {
+            if(m_ctl.stopcondition()) break;
+            shapecache.merge(bs.shape);
+        }
+
+        if(m_ctl.stopcondition()) {
+            shapecache.clear();
+            return shapecache;
+        }
+
+        shapecache_valid = true;
+        return shapecache;
+    }
+
     // WITH THE PAD
     double full_height() const {
         if(merged_mesh().empty() && !pad().empty())
@@ -937,6 +1196,7 @@ public:
     // Intended to be called after the generation is fully complete
     void clear_support_data() {
         merged_mesh(); // in case the mesh is not generated, it should be...
+        merged_shape(); // the slicing needs it after the parts are gone
         m_heads.clear();
         m_pillars.clear();
         m_junctions.clear();
@@ -1042,6 +1302,105 @@ class SLASupportTree::Algorithm {
         return m_mesh.query_ray_hit(s, dir).distance();
     }
 
+    // Number of rays shot around the circumference of a pinhead or a bridge
+    // for the collision checks.
+    static const size_t SAMPLES = 8;
+
+    // Two vectors that will be perpendicular to each other and to the axis
+    // given by dir.
+    static void perpendicular_basis(const Vec3d& dir, Vec3d& a, Vec3d& b)
+    {
+        // method based on:
+        // https://math.stackexchange.com/questions/73237/parametric-equation-of-a-circle-in-3d-space
+
+        // Values for a(X) and a(Y) are now arbitrary, a(Z) is just a
+        // placeholder.
+        a = {0, 1, 0};
+
+        // We have to address the case when the direction vector v (same as
+        // dir) is coincident with one of the world axes. In this case two of
+        // its components will be completely zero and one is 1.0. Our method
+        // becomes dangerous here due to division with zero. Instead, vector
+        // 'a' can be an element-wise rotated version of 'v'
+        auto chk1 = [] (double val) {
+            return std::abs(std::abs(val) - 1) < 1e-20;
+        };
+
+        if(chk1(dir(X)) || chk1(dir(Y)) || chk1(dir(Z))) {
+            a = {dir(Z), dir(X), dir(Y)};
+            b = {dir(Y), dir(Z), dir(X)};
+        }
+        else {
+            a(Z) = -(dir(Y)*a(Y)) / dir(Z); a.normalize();
+            b = a.cross(dir);
+        }
+    }
+
+    // Cast the rays of several collision checks in one batch. Each check
+    // consists of SAMPLES consecutive rays and its result is the nearest
+    // hit of these rays. If a ray of a check starts inside the model and
+    // the hit is not farther than the check's inside limit, the ray is
+    // re-cast from the outside of the object. If the hit is farther, the
+    // result is an invalid hit with zero distance. A negative inside limit
+    // disables the inside check.
+    std::vector<EigenMesh3D::hit_result> cast_collision_rays(
+            const std::vector<Vec3d>& sources,
+            const std::vector<Vec3d>& dirs,
+            const std::vector<double>& inside_limits)
+    {
+        using HitResult = EigenMesh3D::hit_result;
+        const double& sd = m_cfg.safety_distance_mm;
+
+        assert(sources.size() == SAMPLES * inside_limits.size());
+
+        std::vector<HitResult> hits = m_mesh.query_ray_hits(sources, dirs);
+
+        // Gather the rays to re-cast from the outside of the object. The
+        // re-cast starts with a 2*safety_distance offset from the surface
+        // because the original ray has also had an offset.
+        std::vector<size_t> recast;
+        std::vector<Vec3d> rsources, rdirs;
+        for(size_t i = 0; i < hits.size(); ++i) {
+            double limit = inside_limits[i / SAMPLES];
+            if(limit < 0 || !hits[i].is_inside()) continue;
+
+            if(hits[i].distance() > limit) {
+                // If we are inside the model and the hit distance is bigger
+                // than the limit, it probably indicates that the support
+                // point was already inside the model, or there is really
+                // no space around the point. We will assign a zero hit
+                // distance to these cases which will enforce the result of
+                // the check to be an invalid ray with zero hit distance.
+                hits[i] = HitResult(0.0);
+            } else {
+                recast.emplace_back(i);
+                rsources.emplace_back(sources[i] +
+                                      (hits[i].distance() + sd) * dirs[i]);
+                rdirs.emplace_back(dirs[i]);
+            }
+        }
+
+        if(!recast.empty()) {
+            std::vector<HitResult> rhits = m_mesh.query_ray_hits(rsources,
+                                                                 rdirs);
+            for(size_t i = 0; i < recast.size(); ++i)
+                hits[recast[i]] = rhits[i];
+        }
+
+        std::vector<HitResult> ret;
+        ret.reserve(inside_limits.size());
+        for(auto it = hits.begin(); it != hits.end(); it += SAMPLES)
+            ret.emplace_back(*std::min_element(it, it + SAMPLES));
+
+        return ret;
+    }
+
+    // Parameters of a pinhead collision check, see pinhead_mesh_intersect
+    struct PinheadQuery {
+        Vec3d s, dir;
+        double r_pin, r_back, width;
+    };
+
     // This function will test if a future pinhead would not collide with the
     // model geometry. It does not take a 'Head' object because those are
     // created after this test. Parameters: s: The touching point on the model
@@ -1060,116 +1419,86 @@ class SLASupportTree::Algorithm {
             double r_back,
             double width)
     {
-        static const size_t SAMPLES = 8;
-
-        // method based on:
-        // https://math.stackexchange.com/questions/73237/parametric-equation-of-a-circle-in-3d-space
-
-        // We will shoot multiple rays from the head pinpoint in the direction
-        // of the pinhead robe (side) surface. The result will be the smallest
-        // hit distance.
+        return pinhead_mesh_intersect({{s, dir, r_pin, r_back, width}}).front();
+    }
 
-        // Move away slightly from the touching point to avoid raycasting on the
-        // inner surface of the mesh.
-        Vec3d v = dir;     // Our direction (axis)
-        Vec3d c = s + width * dir;
+    // The same check for multiple pinheads, the rays of all the checks are
+    // cast in one batch.
+    std::vector<EigenMesh3D::hit_result> pinhead_mesh_intersect(
+            const std::vector<PinheadQuery>& queries)
+    {
         const double& sd = m_cfg.safety_distance_mm;
 
-        // Two vectors that will be perpendicular to each other and to the
-        // axis. Values for a(X) and a(Y) are now arbitrary, a(Z) is just a
-        // placeholder.
-        Vec3d a(0, 1, 0), b;
-
         // The portions of the circle (the head-back circle) for which we will
         // shoot rays.
         std::array<double, SAMPLES> phis;
         for(size_t i = 0; i < phis.size(); ++i) phis[i] = i*2*PI/phis.size();
 
-        auto& m = m_mesh;
-        using HitResult = EigenMesh3D::hit_result;
-
-        // Hit results
-        std::array<HitResult, SAMPLES> hits;
-
-        // We have to address the case when the direction vector v (same as
-        // dir) is coincident with one of the world axes. In this case two of
-        // its components will be completely zero and one is 1.0. Our method
-        // becomes dangerous here due to division with zero. Instead, vector
-        // 'a' can be an element-wise rotated version of 'v'
-        auto chk1 = [] (double val) {
-            return std::abs(std::abs(val) - 1) < 1e-20;
-        };
+        std::vector<Vec3d> sources, dirs;
+        std::vector<double> inside_limits;
+        sources.reserve(SAMPLES * queries.size());
+        dirs.reserve(SAMPLES * queries.size());
+        inside_limits.reserve(queries.size());
+
+        for(const PinheadQuery& q : queries) {
+            // We will shoot multiple rays from the head pinpoint in the
+            // direction of the pinhead robe (side) surface. The result will
+            // be the smallest hit distance.
+
+            // Move away slightly from the touching point to avoid raycasting
+            // on the inner surface of the mesh.
+            const Vec3d& s = q.s;
+            Vec3d c = s + q.width * q.dir;
+
+            // Now a and b vectors are perpendicular to v and to each other.
+            // Together they define the plane where we have to iterate with
+            // the given angles in the 'phis' vector
+            Vec3d a, b;
+            perpendicular_basis(q.dir, a, b);
+
+            for(double phi : phis) {
+                double sinphi = std::sin(phi);
+                double cosphi = std::cos(phi);
+
+                // Let's have a safety coefficient for the radiuses.
+                double rpscos = (sd + q.r_pin) * cosphi;
+                double rpssin = (sd + q.r_pin) * sinphi;
+                double rpbcos = (sd + q.r_back) * cosphi;
+                double rpbsin = (sd + q.r_back) * sinphi;
+
+                // Point on the circle on the pin sphere
+                Vec3d ps(s(X) + rpscos * a(X) + rpssin * b(X),
+                         s(Y) + rpscos * a(Y) + rpssin * b(Y),
+                         s(Z) + rpscos * a(Z) + rpssin * b(Z));
+
+                // Point ps is not on mesh but can be inside or outside as
+                // well. This would cause many problems with ray-casting. To
+                // detect the position we will use the ray-casting result
+                // (which has an is_inside predicate).
+
+                // This is the point on the circle on the back sphere
+                Vec3d p(c(X) + rpbcos * a(X) + rpbsin * b(X),
+                        c(Y) + rpbcos * a(Y) + rpbsin * b(Y),
+                        c(Z) + rpbcos * a(Z) + rpbsin * b(Z));
+
+                Vec3d n = (p - ps).normalized();
+                sources.emplace_back(ps + sd*n);
+                dirs.emplace_back(n);
+            }
 
-        if(chk1(v(X)) || chk1(v(Y)) || chk1(v(Z))) {
-            a = {v(Z), v(X), v(Y)};
-            b = {v(Y), v(Z), v(X)};
-        }
-        else {
-            a(Z) = -(v(Y)*a(Y)) / v(Z); a.normalize();
-            b = a.cross(v);
+            inside_limits.emplace_back(q.r_pin + sd);
         }
 
-        // Now a and b vectors are perpendicular to v and to each other.
-        // Together they define the plane where we have to iterate with the
-        // given angles in the 'phis' vector
-        tbb::parallel_for(size_t(0), phis.size(),
-                          [&phis, &hits, &m, sd, r_pin, r_back, s, a, b, c]
-                          (size_t i)
-        {
-            double& phi = phis[i];
-            double sinphi = std::sin(phi);
-            double cosphi = std::cos(phi);
-
-            // Let's have a safety coefficient for the radiuses.
-            double rpscos = (sd + r_pin) * cosphi;
-            double rpssin = (sd + r_pin) * sinphi;
-            double rpbcos = (sd + r_back) * cosphi;
-            double rpbsin = (sd + r_back) * sinphi;
-
-            // Point on the circle on the pin sphere
-            Vec3d ps(s(X) + rpscos * a(X) + rpssin * b(X),
-                     s(Y) + rpscos * a(Y) + rpssin * b(Y),
-                     s(Z) + rpscos * a(Z) + rpssin * b(Z));
-
-            // Point ps is not on mesh but can be inside or outside as well.
-            // This would cause many problems with ray-casting. To detect the
-            // position we will use the ray-casting result (which has an
-            // is_inside predicate).
-
-            // This is the point on the circle on the back sphere
-            Vec3d p(c(X) + rpbcos * a(X) + rpbsin * b(X),
-                    c(Y) + rpbcos * a(Y) + rpbsin * b(Y),
-                    c(Z) + rpbcos * a(Z) + rpbsin * b(Z));
-
-            Vec3d n = (p - ps).normalized();
-            auto q = m.query_ray_hit(ps + sd*n, n);
-
-            if(q.is_inside()) { // the hit is inside the model
-                if(q.distance() > r_pin + sd)  {
-                    // If we are inside the model and the hit distance is bigger
-                    // than our pin circle diameter, it probably indicates that
-                    // the support point was already inside the model, or there
-                    // is really no space around the point. We will assign a
-                    // zero hit distance to these cases which will enforce the
-                    // function return value to be an invalid ray with zero hit
-                    // distance. (see min_element at the end)
-                    hits[i] = HitResult(0.0);
-                }
-                else {
-                    // re-cast the ray from the outside of the object.
-                    // The starting point has an offset of 2*safety_distance
-                    // because the original ray has also had an offset
-                    auto q2 = m.query_ray_hit(ps + (q.distance() + 2*sd)*n, n);
-                    hits[i] = q2;
-                }
-            } else hits[i] = q;
-        });
-
-        auto mit = std::min_element(hits.begin(), hits.end());
-
-        return *mit;
+        return cast_collision_rays(sources, dirs, inside_limits);
     }
 
+    // Parameters of a bridge collision check, see bridge_mesh_intersect
+    struct BridgeQuery {
+        Vec3d s, dir;
+        double r;
+        bool ins_check;
+    };
+
     // Checking bridge (pillar and stick as well) intersection with the model.
     // If the function is used for headless sticks, the ins_check parameter
     // have to be true as the beginning of the stick might be inside the model
@@ -1184,72 +1513,57 @@ class SLASupportTree::Algorithm {
             double r,
             bool ins_check = false)
     {
-        static const size_t SAMPLES = 8;
+        return bridge_mesh_intersect({{s, dir, r, ins_check}}).front();
+    }
 
-        // helper vector calculations
-        Vec3d a(0, 1, 0), b;
+    // The same check for multiple bridges, the rays of all the checks are
+    // cast in one batch.
+    std::vector<EigenMesh3D::hit_result> bridge_mesh_intersect(
+            const std::vector<BridgeQuery>& queries)
+    {
         const double& sd = m_cfg.safety_distance_mm;
 
         // INFO: for explanation of the method used here, see the previous
         // method's comments.
 
-        auto chk1 = [] (double val) {
-            return std::abs(std::abs(val) - 1) < 1e-20;
-        };
-
-        if(chk1(dir(X)) || chk1(dir(Y)) || chk1(dir(Z))) {
-            a = {dir(Z), dir(X), dir(Y)};
-            b = {dir(Y), dir(Z), dir(X)};
-        }
-        else {
-            a(Z) = -(dir(Y)*a(Y)) / dir(Z); a.normalize();
-            b = a.cross(dir);
-        }
-
         // circle portions
         std::array<double, SAMPLES> phis;
         for(size_t i = 0; i < phis.size(); ++i) phis[i] = i*2*PI/phis.size();
 
-        auto& m = m_mesh;
-        using HitResult = EigenMesh3D::hit_result;
+        std::vector<Vec3d> sources, dirs;
+        std::vector<double> inside_limits;
+        sources.reserve(SAMPLES * queries.size());
+        dirs.reserve(SAMPLES * queries.size());
+        inside_limits.reserve(queries.size());
 
-        // Hit results
-        std::array<HitResult, SAMPLES> hits;
+        for(const BridgeQuery& q : queries) {
+            const Vec3d& s = q.s;
 
-        tbb::parallel_for(size_t(0), phis.size(),
-                          [&m, &phis, a, b, sd, dir, r, s, ins_check, &hits]
-                          (size_t i)
-        {
-            double& phi = phis[i];
-            double sinphi = std::sin(phi);
-            double cosphi = std::cos(phi);
+            // helper vector calculations
+            Vec3d a, b;
+            perpendicular_basis(q.dir, a, b);
 
-            // Let's have a safety coefficient for the radiuses.
-            double rcos = (sd + r) * cosphi;
-            double rsin = (sd + r) * sinphi;
+            for(double phi : phis) {
+                double sinphi = std::sin(phi);
+                double cosphi = std::cos(phi);
 
-            // Point on the circle on the pin sphere
-            Vec3d p (s(X) + rcos * a(X) + rsin * b(X),
-                     s(Y) + rcos * a(Y) + rsin * b(Y),
-                     s(Z) + rcos * a(Z) + rsin * b(Z));
+                // Let's have a safety coefficient for the radiuses.
+                double rcos = (sd + q.r) * cosphi;
+                double rsin = (sd + q.r) * sinphi;
 
-            auto hr = m.query_ray_hit(p + sd*dir, dir);
+                // Point on the circle on the pin sphere
+                Vec3d p (s(X) + rcos * a(X) + rsin * b(X),
+                         s(Y) + rcos * a(Y) + rsin * b(Y),
+                         s(Z) + rcos * a(Z) + rsin * b(Z));
 
-            if(ins_check && hr.is_inside()) {
-                if(hr.distance() > 2 * r + sd) hits[i] = HitResult(0.0);
-                else {
-                    // re-cast the ray from the outside of the object
-                    auto hr2 =
-                           m.query_ray_hit(p + (hr.distance() + 2*sd)*dir, dir);
-
-                    hits[i] = hr2;
-                }
-            } else hits[i] = hr;
-        });
+                sources.emplace_back(p + sd*q.dir);
+                dirs.emplace_back(q.dir);
+            }
 
-        auto mit = std::min_element(hits.begin(), hits.end());
+            inside_limits.emplace_back(q.ins_check ? 2 * q.r + sd : -1.);
+        }
 
-        return *mit;
+        return cast_collision_rays(sources, dirs, inside_limits);
     }
 
     // Helper function for interconnecting two pillars with zig-zag bridges.
@@ -1637,11 +1951,27 @@ public:
         using libnest2d::opt::GeneticOptimizer;
         using libnest2d::opt::StopCriteria;
 
-        for(unsigned i = 0, fidx = 0; i < filtered_indices.size(); ++i)
+        // The candidate heads with their initial (saturated) normals. The
+        // collision checks of all the candidates are cast in one batch.
+        struct Candidate {
+            unsigned fidx;
+            double polar, azimuth;
+        };
+
+        std::vector<Candidate> candidates;
+        std::vector<PinheadQuery> queries;
+        candidates.reserve(filtered_indices.size());
+        queries.reserve(filtered_indices.size());
+
+        double w = m_cfg.head_width_mm +
+                   m_cfg.head_back_radius_mm +
+                   2*m_cfg.head_front_radius_mm;
+
+        for(unsigned i = 0; i < filtered_indices.size(); ++i)
         {
             m_thr();
 
-            fidx = filtered_indices[i];
+            unsigned fidx = filtered_indices[i];
             auto n = nmls.row(i);
 
             // for all normals we generate the spherical coordinates and
@@ -1662,27 +1992,53 @@ public:
                 // We saturate the polar angle to 3pi/4
                 polar = std::max(polar, 3*PI / 4);
 
-                // save the head (pinpoint) position
-                Vec3d hp = m_points.row(fidx);
-
-                double w = m_cfg.head_width_mm +
-                           m_cfg.head_back_radius_mm +
-                           2*m_cfg.head_front_radius_mm;
-
-                double pin_r = double(m_support_pts[fidx].head_front_radius);
-
                 // Reassemble the now corrected normal
                 auto nn = Vec3d(std::cos(azimuth) * std::sin(polar),
                                 std::sin(azimuth) * std::sin(polar),
                                 std::cos(polar)).normalized();
 
+                candidates.push_back({fidx, polar, azimuth});
+
                 // check available distance
-                EigenMesh3D::hit_result t
-                    = pinhead_mesh_intersect(hp, // touching point
-                                             nn, // normal
-                                             pin_r,
-                                             m_cfg.head_back_radius_mm,
-                                             w);
+                queries.push_back({m_points.row(fidx), // touching point
+                                   nn,                 // normal
+                                   double(m_support_pts[fidx].head_front_radius),
+                                   m_cfg.head_back_radius_mm,
+                                   w});
+            }
+        }
+
+        m_thr();
+
+        std::vector<EigenMesh3D::hit_result> hits =
+            pinhead_mesh_intersect(queries);
+
+        // Trying to find better angles for the colliding candidates is
+        // independent for each candidate so it runs in parallel. The results
+        // are classified afterwards in the order of the candidates, the output
+        // does not depend on the scheduling of the threads.
+        std::vector<Vec3d>  cnormals(candidates.size());
+        std::vector<double> cpolars(candidates.size());
+        std::vector<double> cdists(candidates.size());
+
+        tbb::parallel_for(tbb::blocked_range<size_t>(0, candidates.size()),
+                          [this, w, &candidates, &queries, &hits, &cnormals,
+                           &cpolars, &cdists]
+                          (const tbb::blocked_range<size_t>& range)
+        {
+            for(size_t i = range.begin(); i < range.end(); ++i)
+            {
+                m_thr();
+
+                double polar   = candidates[i].polar;
+                double azimuth = candidates[i].azimuth;
+
+                // save the head (pinpoint) position
+                Vec3d hp = queries[i].s;
+                Vec3d nn = queries[i].dir;
+                double pin_r = queries[i].r_pin;
+
+                EigenMesh3D::hit_result t = hits[i];
 
                 if(t.distance() <= w) {
 
@@ -1695,24 +2051,33 @@ public:
                     stc.relative_score_difference = m_cfg.optimizer_rel_score_diff;
                     stc.stop_score = w; // space greater than w is enough
                     GeneticOptimizer solver(stc);
-                    solver.seed(0); // we want deterministic behavior
 
-                    auto oresult = solver.optimize_max(
-                        [this, pin_r, w, hp](double plr, double azm)
-                    {
-                        auto n = Vec3d(std::cos(azm) * std::sin(plr),
-                                       std::sin(azm) * std::sin(plr),
-                                       std::cos(plr)).normalized();
-
-                        double score = pinhead_mesh_intersect( hp, n, pin_r,
-                                          m_cfg.head_back_radius_mm, w);
-
-                        return score;
-                    },
-                    initvals(polar, azimuth), // start with what we have
-                    bound(3*PI/4, PI),  // Must not exceed the tilt limit
-                    bound(-PI, PI)      // azimuth can be a full search
-                    );
+                    // The seed sets the random generator of nlopt, which is
+                    // thread local. The ray casts of the objective run in
+                    // parallel, so without the isolation this thread could
+                    // pick up the optimization of another candidate while
+                    // waiting for them and reseed the generator in the middle.
+                    libnest2d::opt::Result<double, double> oresult;
+                    tbb::this_task_arena::isolate([&] {
+                        solver.seed(0); // we want deterministic behavior
+
+                        oresult = solver.optimize_max(
+                            [this, pin_r, w, hp](double plr, double azm)
+                        {
+                            auto n = Vec3d(std::cos(azm) * std::sin(plr),
+                                           std::sin(azm) * std::sin(plr),
+                                           std::cos(plr)).normalized();
+
+                            double score = pinhead_mesh_intersect( hp, n, pin_r,
+                                              m_cfg.head_back_radius_mm, w);
+
+                            return score;
+                        },
+                        initvals(polar, azimuth), // start with what we have
+                        bound(3*PI/4, PI),  // Must not exceed the tilt limit
+                        bound(-PI, PI)      // azimuth can be a full search
+                        );
+                    });
 
                     if(oresult.score > w) {
                         polar = std::get<0>(oresult.optimum);
@@ -1724,22 +2089,33 @@ public:
                     }
                 }
 
-                // save the verified and corrected normal
-                m_support_nmls.row(fidx) = nn;
+                cnormals[i] = nn;
+                cpolars[i]  = polar;
+                cdists[i]   = t.distance();
+            }
+        });
 
-                if (t.distance() > w) {
-                    // Check distance from ground, we might have zero elevation.
-                    if (hp(Z) + w * nn(Z) < m_result.ground_level) {
-                        m_iheadless.emplace_back(fidx);
-                    } else {
-                        // mark the point for needing a head.
-                        m_iheads.emplace_back(fidx);
-                    }
-                } else if (polar >= 3 * PI / 4) {
-                    // Headless supports do not tilt like the headed ones
-                    // so the normal should point almost to the ground.
+        for(size_t i = 0; i < candidates.size(); ++i)
+        {
+            unsigned fidx = candidates[i].fidx;
+            const Vec3d& hp = queries[i].s;
+            const Vec3d& nn = cnormals[i];
+
+            // save the verified and corrected normal
+            m_support_nmls.row(fidx) = nn;
+
+            if (cdists[i] > w) {
+                // Check distance from ground, we might have zero elevation.
+                if (hp(Z) + w * nn(Z) < m_result.ground_level) {
                     m_iheadless.emplace_back(fidx);
+                } else {
+                    // mark the point for needing a head.
+                    m_iheads.emplace_back(fidx);
                 }
+            } else if (cpolars[i] >= 3 * PI / 4) {
+                // Headless supports do not tilt like the headed ones
+                // so the normal should point almost to the ground.
+                m_iheadless.emplace_back(fidx);
             }
         }
 
@@ -1750,18 +2126,29 @@ public:
     // will be constructed (together with their triangle meshes).
     void add_pinheads()
     {
-        for (unsigned i : m_iheads) {
-            m_thr();
-            m_result.add_head(
-                        i,
+        // The head geometries are generated in parallel and added to the
+        // result in the order of the support points.
+        std::vector<std::unique_ptr<Head>> heads(m_iheads.size());
+
+        tbb::parallel_for(tbb::blocked_range<size_t>(0, m_iheads.size()),
+                          [this, &heads](const tbb::blocked_range<size_t>& range)
+        {
+            for(size_t k = range.begin(); k < range.end(); ++k) {
+                m_thr();
+                unsigned i = m_iheads[k];
+                heads[k].reset(new Head(
                         m_cfg.head_back_radius_mm,
                         m_support_pts[i].head_front_radius,
                         m_cfg.head_width_mm,
                         m_cfg.head_penetration_mm,
                         m_support_nmls.row(i),         // dir
                         m_support_pts[i].pos.cast<double>() // displacement
-                        );
-        }
+                        ));
+            }
+        });
+
+        for(size_t k = 0; k < m_iheads.size(); ++k)
+            m_result.add_head(m_iheads[k], std::move(*heads[k]));
     }
 
     // Further classification of the support points with pinheads. If the
@@ -1783,16 +2170,24 @@ public:
         // pillars and which shall be connected to the model surface (or
         // search a suitable path around the surface that leads to the
         // ground -- TODO)
+        std::vector<BridgeQuery> queries;
+        queries.reserve(m_iheads.size());
         for(unsigned i : m_iheads) {
+            const Head& head = m_result.head(i);
+            queries.push_back({head.junction_point(), Vec3d(0, 0, -1),
+                               head.r_back_mm, false});
+        }
+
+        // collision check of all the heads in one batch
+        std::vector<EigenMesh3D::hit_result> hits =
+            bridge_mesh_intersect(queries);
+
+        for(size_t k = 0; k < m_iheads.size(); ++k) {
             m_thr();
 
+            unsigned i = m_iheads[k];
             auto& head = m_result.head(i);
-            Vec3d n(0, 0, -1);
-            double r = head.r_back_mm;
-            Vec3d headjp = head.junction_point();
-
-            // collision check
-            auto hit = bridge_mesh_intersect(headjp, n, r);
+            const EigenMesh3D::hit_result& hit = hits[k];
 
             if(std::isinf(hit.distance())) ground_head_indices.emplace_back(i);
             else if(m_cfg.ground_facing_only)  head.invalidate();
@@ -1835,7 +2230,30 @@ public:
         ClusterEl cl_centroids;
         cl_centroids.reserve(m_pillar_clusters.size());
 
-        for(auto& cl : m_pillar_clusters) { m_thr();
+        // The cluster centroids only depend on the support points so they
+        // are searched for in parallel. The pillars are created afterwards
+        // in the order of the clusters.
+        std::vector<long> lcids(m_pillar_clusters.size(), -1);
+        tbb::parallel_for(tbb::blocked_range<size_t>(0, m_pillar_clusters.size()),
+                          [this, &lcids](const tbb::blocked_range<size_t>& range)
+        {
+            for(size_t ci = range.begin(); ci < range.end(); ++ci) {
+                const PtIndices& cl = m_pillar_clusters[ci];
+                if(cl.empty()) continue;
+
+                // get the current cluster centroid
+                auto& thr = m_thr; const auto& points = m_points;
+                lcids[ci] = cluster_centroid(cl,
+                    [&points](size_t idx) { return points.row(long(idx)); },
+                    [thr](const Vec3d& p1, const Vec3d& p2)
+                {
+                    thr();
+                    return distance(Vec2d(p1(X), p1(Y)), Vec2d(p2(X), p2(Y)));
+                });
+            }
+        });
+
+        for(size_t ci = 0; ci < m_pillar_clusters.size(); ++ci) { m_thr();
             // place all the centroid head positions into the index. We
             // will query for alternative pillar positions. If a sidehead
             // cannot connect to the cluster centroid, we have to search
@@ -1844,17 +2262,10 @@ public:
             // sidehead is allowed to connect to a nearby pillar to
             // increase structural stability.
 
+            const PtIndices& cl = m_pillar_clusters[ci];
             if(cl.empty()) continue;
 
-            // get the current cluster centroid
-            auto& thr = m_thr; const auto& points = m_points;
-            long lcid = cluster_centroid(cl,
-                [&points](size_t idx) { return points.row(long(idx)); },
-                [thr](const Vec3d& p1, const Vec3d& p2)
-            {
-                thr();
-                return distance(Vec2d(p1(X), p1(Y)), Vec2d(p2(X), p2(Y)));
-            });
+            long lcid = lcids[ci];
 
             assert(lcid >= 0);
             unsigned hid = cl[size_t(lcid)]; // Head ID
@@ -2067,6 +2478,7 @@ public:
 
                 tailhead.transform();
                 pill.base = tailhead.mesh;
+                pill.base_shape = tailhead.shape;
 
                 // Experimental: add the pillar to the index for cascading
                 modelpillars.emplace_back(unsigned(pill.id));
@@ -2511,25 +2923,48 @@ std::vector<ExPolygons> SLASupportTree::slice(float layerh, float init_layerh) c
         heights.emplace_back(h);
     }
 
-    TriangleMesh fullmesh = m_impl->merged_mesh();
-    fullmesh.merge(get_pad());
-    if (!fullmesh.empty()) fullmesh.require_shared_vertices();
-    TriangleMeshSlicer slicer(&fullmesh);
-    std::vector<ExPolygons> ret;
-    slicer.slice(heights, 0.f, &ret, get().ctl().cancelfn);
-
-    return ret;
+    return slice(heights, 0.f);
 }
 
 std::vector<ExPolygons> SLASupportTree::slice(const std::vector<float> &heights,
                                      float cr) const
 {
-    TriangleMesh fullmesh = m_impl->merged_mesh();
-    fullmesh.merge(get_pad());
-    if (!fullmesh.empty()) fullmesh.require_shared_vertices();
-    TriangleMeshSlicer slicer(&fullmesh);
-    std::vector<ExPolygons> ret;
-    slicer.slice(heights, cr, &ret, get().ctl().cancelfn);
+    const Primitives& shape = m_impl->merged_shape();
+    auto& cancelfn = get().ctl().cancelfn;
+
+    // Only the pad is sliced as a mesh, the support parts are intersected
+    // with the slicing planes analytically.
+    std::vector<ExPolygons> padslices;
+    const TriangleMesh& padmesh = get_pad();
+    if(!padmesh.empty()) {
+        TriangleMesh pmesh = padmesh;
+        pmesh.require_shared_vertices();
+        TriangleMeshSlicer slicer(&pmesh);
+        slicer.slice(heights, 0.f, &padslices, cancelfn);
+    }
+
+    std::vector<ExPolygons> ret(heights.size());
+
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, heights.size()),
+                      [&](const tbb::blocked_range<size_t>& range)
+    {
+        for(size_t i = range.begin(); i < range.end(); ++i) {
+            cancelfn();
+
+            Polygons layer;
+            shape.slice(double(heights[i]), layer);
+            if(i < padslices.size())
+                polygons_append(layer, to_polygons(padslices[i]));
+
+            if(layer.empty()) continue;
+
+            if(cr > 0.f)
+                ret[i] = offset2_ex(union_(layer), float(scale_(cr)),
+                                    -float(scale_(cr)));
+            else
+                ret[i] = union_ex(layer);
+        }
+    });
 
     return ret;
 }
@@ -2537,7 +2972,7 @@ std::vector<ExPolygons> SLASupportTree::slice(const std::vector<float> &heights,
 const TriangleMesh &SLASupportTree::add_pad(const ExPolygons& modelbase,
                                             const PoolConfig& pcfg) const
 {
-    return m_impl->create_pad(merged_mesh(), modelbase, pcfg).tmesh;
+    return m_impl->create_pad(modelbase, pcfg).tmesh;
 }
 
 const TriangleMesh &SLASupportTree::get_pad() const
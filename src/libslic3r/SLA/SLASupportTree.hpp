@@ -183,7 +183,9 @@ public:
 
     void merged_mesh_with_pad(TriangleMesh&) const;
 
-    /// Get the sliced 2d layers of the support geometry.
+    /// Get the sliced 2d layers of the support geometry. The support parts are
+    /// intersected with the slicing planes analytically, only the pad is
+    /// sliced as a mesh. The merged mesh is used for display and export.
     std::vector<ExPolygons> slice(float layerh, float init_layerh = -1.0) const;
 
     std::vector<ExPolygons> slice(const std::vector<float> &,
@@ -213,14 +213,14 @@ EigenMesh3D::~EigenMesh3D() {}
 
 EigenMesh3D::EigenMesh3D(const EigenMesh3D &other):
     m_V(other.m_V), m_F(other.m_F), m_ground_level(other.m_ground_level),
-    m_aabb( new AABBImpl(*other.m_aabb) ) {}
+    m_aabb(other.m_aabb) {}
 
 EigenMesh3D &EigenMesh3D::operator=(const EigenMesh3D &other)
 {
     m_V = other.m_V;
     m_F = other.m_F;
     m_ground_level = other.m_ground_level;
-    m_aabb.reset(new AABBImpl(*other.m_aabb)); return *this;
+    m_aabb = other.m_aabb; return *this;
 }
 
 EigenMesh3D::hit_result
@@ -239,6 +239,24 @@ EigenMesh3D::query_ray_hit(const Vec3d &s, const Vec3d &dir) const
     return ret;
 }
 
+std::vector<EigenMesh3D::hit_result>
+EigenMesh3D::query_ray_hits(const std::vector<Vec3d> &sources,
+                            const std::vector<Vec3d> &dirs) const
+{
+    assert(sources.size() == dirs.size());
+
+    std::vector<hit_result> ret(sources.size());
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, sources.size()),
+                      [this, &sources, &dirs, &ret]
+                      (const tbb::blocked_range<size_t>& range)
+    {
+        for(size_t i = range.begin(); i < range.end(); ++i)
+            ret[i] = query_ray_hit(sources[i], dirs[i]);
+    });
+
+    return ret;
+}
+
 #ifdef SLIC3R_SLA_NEEDS_WINDTREE
 EigenMesh3D::si_result EigenMesh3D::signed_distance(const Vec3d &p) const {
     double sign = 0; double sqdst = 0; int i = 0;  Vec3d c;
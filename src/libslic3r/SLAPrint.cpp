@@ -36,7 +36,8 @@ public:
     SupportTreePtr                 support_tree_ptr;   // the supports
     std::vector<ExPolygons>        support_slices;     // sliced supports
 
-    inline SupportData(const TriangleMesh &trmesh) : emesh(trmesh) {}
+    // The copy of the mesh shares the AABB tree of the cached one.
+    inline SupportData(const sla::EigenMesh3D &em) : emesh(em) {}
 };
 
 namespace {
@@ -792,7 +793,7 @@ void SLAPrint::process()
            po.m_config.pad_enable.getBool())
         {
             po.m_supportdata.reset(
-                new SLAPrintObject::SupportData(po.transformed_mesh()) );
+                new SLAPrintObject::SupportData(po.transformed_emesh()) );
         }
     };
 
@@ -804,7 +805,7 @@ void SLAPrint::process()
 
         if (!po.m_supportdata)
             po.m_supportdata.reset(
-                new SLAPrintObject::SupportData(po.transformed_mesh()));
+                new SLAPrintObject::SupportData(po.transformed_emesh()));
 
         const ModelObject& mo = *po.m_model_object;
 
@@ -976,7 +977,6 @@ void SLAPrint::process()
 
             ExPolygons bp; // This will store the base plate of the pad.
             double   pad_h             = sla::get_pad_fullheight(pcfg);
-            const TriangleMesh &trmesh = po.transformed_mesh();
 
             // This call can get pretty time consuming
             auto thrfn = [this](){ throw_if_canceled(); };
@@ -985,12 +985,11 @@ void SLAPrint::process()
                 // No support (thus no elevation) or zero elevation mode
                 // we sometimes call it "builtin pad" is enabled so we will
                 // get a sample from the bottom of the mesh and use it for pad
-                // creation.
-                sla::base_plate(trmesh,
-                                bp,
-                                float(pad_h),
-                                float(po.m_config.layer_height.getFloat()),
-                                thrfn);
+                // creation. The sample is cached with the object, it only
+                // changes with the pad height.
+                bp = po.model_base_plate(float(pad_h),
+                                         float(po.m_config.layer_height.getFloat()),
+                                         thrfn);
             }
 
             pcfg.throw_on_cancel = thrfn;
@@ -1626,6 +1625,9 @@ SLAPrintObject::SLAPrintObject(SLAPrint *print, ModelObject *model_object)
             obj.require_shared_vertices();
         }
     })
+    , m_transformed_emesh([this](std::shared_ptr<sla::EigenMesh3D> &obj) {
+        obj = std::make_shared<sla::EigenMesh3D>(transformed_mesh());
+    })
 {}
 
 SLAPrintObject::~SLAPrintObject() {}
@@ -1857,6 +1859,25 @@ const TriangleMesh &SLAPrintObject::transformed_mesh() const {
     return m_transformed_rmesh.get();
 }
 
+const sla::EigenMesh3D &SLAPrintObject::transformed_emesh() const {
+    return *m_transformed_emesh.get();
+}
+
+const ExPolygons &SLAPrintObject::model_base_plate(float h, float layerh,
+                                                   std::function<void(void)> thrfn) const
+{
+    std::pair<float, float> key(h, layerh);
+    if(key != m_model_base_plate_key) {
+        // Keep the cache invalid if the sampling gets canceled
+        m_model_base_plate_key = { -1.f, -1.f };
+        m_model_base_plate.clear();
+        sla::base_plate(transformed_mesh(), m_model_base_plate, h, layerh, thrfn);
+        m_model_base_plate_key = key;
+    }
+
+    return m_model_base_plate;
+}
+
 std::vector<sla::SupportPoint> SLAPrintObject::transformed_support_points() const
 {
     assert(m_model_object != nullptr);
@@ -78,6 +78,11 @@ public:
     // This will return the transformed mesh which is cached
     const TriangleMesh&     transformed_mesh() const;
 
+    // The transformed mesh in the index-triangle format with its AABB tree.
+    // It is cached together with the transformed mesh, copies of it share
+    // the AABB tree.
+    const sla::EigenMesh3D& transformed_emesh() const;
+
     std::vector<sla::SupportPoint>      transformed_support_points() const;
 
     // Get the needed Z elevation for the model geometry if supports should be
@@ -250,8 +255,16 @@ protected:
 
     void                    set_trafo(const Transform3d& trafo, bool left_handed) {
         m_transformed_rmesh.invalidate([this, &trafo, left_handed](){ m_trafo = trafo; m_left_handed = left_handed; });
+        m_transformed_emesh.invalidate([](){});
+        m_model_base_plate.clear();
+        m_model_base_plate_key = { -1.f, -1.f };
     }
 
+    // The silhouette of the bottom of the transformed mesh sampled up to the
+    // height h with the layer height layerh (see sla::base_plate()). It is
+    // cached until the transformation or the sampling parameters change.
+    const ExPolygons&       model_base_plate(float h, float layerh, std::function<void(void)> thrfn) const;
+
     template<class InstVec> inline void set_instances(InstVec&& instances) { m_instances = std::forward<InstVec>(instances); }
 
     // Invalidates the step, and its depending steps in SLAPrintObject and SLAPrint.
@@ -287,6 +300,14 @@ private:
     // Caching the transformed (m_trafo) raw mesh of the object
     mutable CachedObject<TriangleMesh>      m_transformed_rmesh;
 
+    // Caching the index-triangle representation of the transformed mesh
+    mutable CachedObject<std::shared_ptr<sla::EigenMesh3D>> m_transformed_emesh;
+
+    // Caching the base plate of the pad created from the transformed mesh,
+    // the key is the sampling height and layer height
+    mutable ExPolygons                      m_model_base_plate;
+    mutable std::pair<float, float>         m_model_base_plate_key = { -1.f, -1.f };
+
     class SupportData;
     std::unique_ptr<SupportData> m_supportdata;
 };
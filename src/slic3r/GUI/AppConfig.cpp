@@ -36,6 +36,8 @@ void AppConfig::set_defaults()
     // Reset the empty fields to defaults.
     if (get("autocenter").empty())
         set("autocenter", "0");
+    if (get("arrange_rotations").empty())
+        set("arrange_rotations", "0");
     // Disable background processing by default as it is not stable.
     if (get("background_processing").empty())
         set("background_processing", "0");
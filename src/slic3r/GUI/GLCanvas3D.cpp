@@ -4895,16 +4895,16 @@ void GLCanvas3D::_load_gcode_extrusion_paths(const GCodePreviewData& preview_dat
     // helper functions to select data in dependence of the extrusion view type
     struct Helper
     {
-        static float path_filter(GCodePreviewData::Extrusion::EViewType type, const ExtrusionPath& path)
+        static float path_filter(GCodePreviewData::Extrusion::EViewType type, const GCodePreviewData::Extrusion::PathAttributes& path)
         {
             switch (type)
             {
             case GCodePreviewData::Extrusion::FeatureType:
-                return (float)path.role();
+                return (float)path.role;
             case GCodePreviewData::Extrusion::Height:
-                return path.height;
+                return path.height();
             case GCodePreviewData::Extrusion::Width:
-                return path.width;
+                return path.width();
             case GCodePreviewData::Extrusion::Feedrate:
                 return path.feedrate;
             case GCodePreviewData::Extrusion::VolumetricRate:
@@ -4992,15 +4992,12 @@ void GLCanvas3D::_load_gcode_extrusion_paths(const GCodePreviewData& preview_dat
 
     // detects filters
     FiltersList filters;
-    for (const GCodePreviewData::Extrusion::Layer& layer : preview_data.extrusion.layers)
+    // all the paths sharing the same attributes share the same filter
+    for (const GCodePreviewData::Extrusion::PathAttributes& path : preview_data.extrusion.paths_attributes)
     {
-        for (const ExtrusionPath& path : layer.paths)
-        {
-            ExtrusionRole role = path.role();
-            float path_filter = Helper::path_filter(preview_data.extrusion.view_type, path);
-            if (std::find(filters.begin(), filters.end(), Filter(path_filter, role)) == filters.end())
-                filters.emplace_back(path_filter, role);
-        }
+        float path_filter = Helper::path_filter(preview_data.extrusion.view_type, path);
+        if (std::find(filters.begin(), filters.end(), Filter(path_filter, path.role)) == filters.end())
+            filters.emplace_back(path_filter, path.role);
     }
 
     // nothing to render, return
@@ -5037,20 +5034,36 @@ void GLCanvas3D::_load_gcode_extrusion_paths(const GCodePreviewData& preview_dat
         }
     }
 
+    // maps the path attributes to the filters
+    std::vector<Filter*> attributes_filters;
+    attributes_filters.reserve(preview_data.extrusion.paths_attributes.size());
+    for (const GCodePreviewData::Extrusion::PathAttributes& path : preview_data.extrusion.paths_attributes)
+    {
+        float path_filter = Helper::path_filter(preview_data.extrusion.view_type, path);
+        FiltersList::iterator filter = std::find(filters.begin(), filters.end(), Filter(path_filter, path.role));
+        attributes_filters.emplace_back((filter != filters.end()) ? &(*filter) : nullptr);
+    }
+
     // populates volumes
+    Polyline polyline;
     for (const GCodePreviewData::Extrusion::Layer& layer : preview_data.extrusion.layers)
     {
-        for (const ExtrusionPath& path : layer.paths)
+        for (size_t i = 0; i < layer.paths_count(); ++i)
         {
-            float path_filter = Helper::path_filter(preview_data.extrusion.view_type, path);
-            FiltersList::iterator filter = std::find(filters.begin(), filters.end(), Filter(path_filter, path.role()));
-            if (filter != filters.end())
+            Filter* filter = attributes_filters[layer.paths_attributes_id[i]];
+            if (filter != nullptr)
             {
+                const GCodePreviewData::Extrusion::PathAttributes& path = preview_data.extrusion.path_attributes(layer, i);
                 filter->volume->print_zs.push_back(layer.z);
                 filter->volume->offsets.push_back(filter->volume->indexed_vertex_array.quad_indices.size());
                 filter->volume->offsets.push_back(filter->volume->indexed_vertex_array.triangle_indices.size());
 
-                _3DScene::extrusionentity_to_verts(path, layer.z, *filter->volume);
+                // the paths were stored without duplicate points by the analyzer
+                polyline.points.assign(layer.path_begin(i), layer.path_end(i));
+                Lines lines = polyline.lines();
+                std::vector<double> widths(lines.size(), path.width());
+                std::vector<double> heights(lines.size(), path.height());
+                _3DScene::thick_lines_to_verts(lines, widths, heights, false, layer.z, *filter->volume);
             }
         }
     }
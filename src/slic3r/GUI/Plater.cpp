@@ -1578,6 +1578,9 @@ struct Plater::priv
         
     } m_ui_jobs{this};
 
+    // The criterion the last started rotation optimization searches for, read by the RotoptimizeJob.
+    sla::RotationObjective      rotoptimize_objective = sla::RotationObjective::axis_alignment;
+
     bool                        delayed_scene_refresh;
     std::string                 delayed_error_message;
 
@@ -1623,7 +1626,7 @@ struct Plater::priv
     void reset();
     void mirror(Axis axis);
     void arrange();
-    void sla_optimize_rotation();
+    void sla_optimize_rotation(sla::RotationObjective objective);
     void split_object();
     void split_volume();
     void scale_selection_to_fit_print_volume();
@@ -2506,8 +2509,9 @@ void Plater::priv::arrange()
 
 // This method will find an optimal orientation for the currently selected item
 // Very similar in nature to the arrange method above...
-void Plater::priv::sla_optimize_rotation() {
+void Plater::priv::sla_optimize_rotation(sla::RotationObjective objective) {
     this->take_snapshot(_(L("Optimize Rotation")));
+    rotoptimize_objective = objective;
     m_ui_jobs.start(Jobs::Rotoptimize);
 }
 
@@ -2544,12 +2548,20 @@ void Plater::priv::ExclusiveJobGroup::ArrangeJob::process() {
 
     arr::WipeTowerInfo wti = view3D->get_canvas3d()->get_wipe_tower_info();
 
+    // Number of candidate rotations of each instance around the Z axis
+    unsigned rotations =
+        wxGetApp().app_config->get("arrange_rotations") == "1" ? 8 : 1;
+
     try {
         arr::BedShapeHint hint;
 
         // TODO: from Sasha from GUI or
         hint.type = arr::BedShapeType::WHO_KNOWS;
 
+        // The nfp placement of hundreds of instances takes too long
+        if (count >= int(arr::SKYLINE_INSTANCE_THRESHOLD))
+            hint.mode = arr::ArrangeMode::SKYLINE;
+
         arr::arrange(model,
                      wti,
                      min_obj_distance,
@@ -2560,7 +2572,8 @@ void Plater::priv::ExclusiveJobGroup::ArrangeJob::process() {
                          if (st > 0)
                              update_status(count - int(st), arrangestr);
                      },
-                     [this]() { return was_canceled(); });
+                     [this]() { return was_canceled(); },
+                     rotations);
     } catch (std::exception & /*e*/) {
         GUI::show_error(plater().q,
                         L("Could not arrange model objects! "
@@ -2590,7 +2603,8 @@ void Plater::priv::ExclusiveJobGroup::RotoptimizeJob::process()
                 update_status(int(s),
                               _(L("Searching for optimal orientation")));
         },
-        [this]() { return was_canceled(); });
+        [this]() { return was_canceled(); },
+        plater().rotoptimize_objective);
 
     const auto *bed_shape_opt =
         plater().config->opt<ConfigOptionPoints>("bed_shape");
@@ -3422,8 +3436,14 @@ bool Plater::priv::complit_init_sla_object_menu()
     sla_object_menu.AppendSeparator();
 
     // Add the automatic rotation sub-menu
-    append_menu_item(&sla_object_menu, wxID_ANY, _(L("Optimize orientation")), _(L("Optimize the rotation of the object for better print results.")),
-        [this](wxCommandEvent&) { sla_optimize_rotation(); });
+    wxMenu* rotation_menu = new wxMenu();
+    append_menu_item(rotation_menu, wxID_ANY, _(L("Align with the axes")), _(L("Rotate the object so that its faces are aligned with the axes.")),
+        [this](wxCommandEvent&) { sla_optimize_rotation(sla::RotationObjective::axis_alignment); });
+    append_menu_item(rotation_menu, wxID_ANY, _(L("Minimize overhangs")), _(L("Rotate the object so that the least area of its faces needs supports.")),
+        [this](wxCommandEvent&) { sla_optimize_rotation(sla::RotationObjective::min_overhangs); });
+    append_menu_item(rotation_menu, wxID_ANY, _(L("Minimize projected area")), _(L("Rotate the object so that its faces cover the least area in the XY plane.")),
+        [this](wxCommandEvent&) { sla_optimize_rotation(sla::RotationObjective::min_projected_facet_area); });
+    append_submenu(&sla_object_menu, rotation_menu, wxID_ANY, _(L("Optimize orientation")), _(L("Optimize the rotation of the object for better print results.")));
 
     return true;
 }
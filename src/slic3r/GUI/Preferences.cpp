@@ -57,6 +57,14 @@ void PreferencesDialog::build()
 	option = Option (def,"autocenter");
 	m_optgroup->append_single_option_line(option);
 
+	def.label = L("Rotate parts when arranging");
+	def.type = coBool;
+	def.tooltip = L("If this is enabled, the arrangement tries eight rotations of the parts "
+					  "around the Z axis to pack them more densely. It takes longer.");
+	def.set_default_value(new ConfigOptionBool{ app_config->get("arrange_rotations") == "1" });
+	option = Option (def,"arrange_rotations");
+	m_optgroup->append_single_option_line(option);
+
 	def.label = L("Background processing");
 	def.type = coBool;
 	def.tooltip = L("If this is enabled, Slic3r will pre-process objects as soon "
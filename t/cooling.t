@@ -2,7 +2,7 @@ use Test::More;
 use strict;
 use warnings;
 
-plan tests => 14;
+plan tests => 20;
 
 BEGIN {
     use FindBin;
@@ -90,6 +90,46 @@ $config->set('disable_fan_first_layers',    [ 0 ]);
     like $gcode, qr/F400/, 'speed is not altered for extruder-only moves';
 }
 
+{
+    # The markers are written by GCodeWriter::set_speed() right after the F word, without a space.
+    my $gcode_src  = 
+        "G1 F3000;_EXTRUDE_SET_SPEED\n" .
+        "G1 X100 E1\n" .
+        ";_EXTRUDE_END\n";
+    my $print_time = 100 / (3000 / 60);
+    my $buffer = buffer($config, { 'slowdown_below_layer_time' => [ $print_time * 1.5 ] });
+    my $gcode  = $buffer->process_layer($gcode_src, 0);
+    unlike $gcode, qr/F3000/, 'speed marked by _EXTRUDE_SET_SPEED is altered';
+    unlike $gcode, qr/_EXTRUDE_SET_SPEED/, '_EXTRUDE_SET_SPEED marker is removed';
+}
+
+{
+    # External perimeters are only slowed down after all the other extrusions reached the minimum speed.
+    my $gcode_src  = 
+        "G1 F3000;_EXTRUDE_SET_SPEED\n" .
+        "G1 X100 E1\n" .
+        ";_EXTRUDE_END\n" .
+        "G1 F2000;_EXTRUDE_SET_SPEED;_EXTERNAL_PERIMETER\n" .
+        "G1 X0 E2\n" .
+        ";_EXTRUDE_END\n";
+    my $print_time = 100 / (3000 / 60) + 100 / (2000 / 60);
+    my $buffer = buffer($config, { 'slowdown_below_layer_time' => [ $print_time * 1.1 ] });
+    my $gcode  = $buffer->process_layer($gcode_src, 0);
+    like $gcode, qr/F2000/, 'speed marked by _EXTERNAL_PERIMETER is not altered';
+    unlike $gcode, qr/_EXTERNAL_PERIMETER/, '_EXTERNAL_PERIMETER marker is removed';
+}
+
+{
+    my $gcode_src  = 
+        "G1 F2400;_WIPE\n" .
+        "G1 X100 E-1\n";
+    my $print_time = 100 / (2400 / 60);
+    my $buffer = buffer($config, { 'slowdown_below_layer_time' => [ $print_time * 1.5 ] });
+    my $gcode  = $buffer->process_layer($gcode_src, 0);
+    like $gcode, qr/F2400/, 'speed marked by _WIPE is not altered';
+    unlike $gcode, qr/_WIPE/, '_WIPE marker is removed';
+}
+
 {
     my $buffer = buffer($config, {
             'fan_below_layer_time'      => [ $print_time1 * 0.88 ],